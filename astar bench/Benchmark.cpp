@@ -0,0 +1,1104 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <memory_resource>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#include "ARAStar.h"
+#include "AStar.h"
+#include "BatchPathFinder.h"
+#include "ComponentIndex.h"
+#include "CooperativePlanner.h"
+#include "FlowField.h"
+#include "FringeSearch.h"
+#include "GridFile.h"
+#include "GridRenderer.h"
+#include "HPAStar.h"
+#include "Landmarks.h"
+#include "Maps.h"
+#include "ParallelAStar.h"
+#include "PathService.h"
+#include "TiledGrid.h"
+#include "args.hxx"
+
+using Clock = std::chrono::steady_clock;
+
+// Upstream allocations of a SearchContext, to report its peak footprint.
+class TrackingResource : public std::pmr::memory_resource {
+public:
+    size_t peak() const { return peakBytes; }
+
+private:
+    size_t currentBytes = 0;
+    size_t peakBytes = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        currentBytes += bytes;
+        peakBytes = std::max(peakBytes, currentBytes);
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        currentBytes -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+struct VariantResult {
+    std::string name;
+    std::vector<double> micros;
+    bool hasStats = false;  // the hierarchy does not report SearchStats
+    long long expanded = 0;
+    long long pushed = 0;
+    long long stalePops = 0;
+    long long reopenings = 0;
+    int peakOpenSize = 0;
+    long long pathCells = 0;
+    int found = 0;
+    size_t peakBytes = 0;
+};
+
+double elapsedMicros(Clock::time_point since) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - since).count();
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[rank];
+}
+
+size_t peakProcessMemory() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = {};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;  // reported in KB on Linux
+#endif
+}
+
+std::vector<PathQuery> makeQueries(const GridView& grid, int count, unsigned seed) {
+    std::vector<int> freeCells;
+    for (int row = 0; row < grid.rows; ++row) {
+        for (int col = 0; col < grid.cols; ++col) {
+            if (grid.at(Point(row, col)) != CELL_WALL) {
+                freeCells.push_back(row * grid.cols + col);
+            }
+        }
+    }
+
+    std::vector<PathQuery> queries;
+    if (freeCells.empty()) {
+        return queries;
+    }
+
+    std::mt19937 rng(seed);
+    for (int i = 0; i < count; ++i) {
+        int a = freeCells[rng() % freeCells.size()];
+        int b = freeCells[rng() % freeCells.size()];
+        PathQuery query;
+        query.start = Point(a / grid.cols, a % grid.cols);
+        query.goal = Point(b / grid.cols, b % grid.cols);
+        queries.push_back(query);
+    }
+    return queries;
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void addQuery(VariantResult& result, const SearchStats& stats, const std::pmr::vector<Point>& path) {
+    result.expanded += stats.expanded;
+    result.pushed += stats.pushed;
+    result.stalePops += stats.stalePops;
+    result.reopenings += stats.reopenings;
+    result.peakOpenSize = std::max(result.peakOpenSize, stats.peakOpenSize);
+    result.pathCells += path.size();
+    result.found += path.empty() ? 0 : 1;
+}
+
+VariantResult runFlat(const std::string& name, SearchMode mode, const GridView& grid, const std::vector<PathQuery>& queries, const Landmarks* landmarks = nullptr) {
+    AStar path_finder;
+    TrackingResource memory;
+    AStar::SearchContext context(&memory);
+    context.setLandmarks(landmarks);
+
+    VariantResult result;
+    result.name = name;
+    result.hasStats = searchStatsEnabled;
+    for (const PathQuery& query : queries) {
+        Clock::time_point begin = Clock::now();
+        const std::pmr::vector<Point>& path = path_finder.findPath(context, grid, query.start, query.goal, mode);
+        result.micros.push_back(elapsedMicros(begin));
+
+        addQuery(result, context.lastStats(), path);
+    }
+    result.peakBytes = memory.peak();
+    return result;
+}
+
+// 8-connected and weighted paths differ from the 4-connected unit-cost ones,
+// so compare their cells only among variants of the same kind.
+template <typename Connectivity, typename Heuristic, typename CostT, typename Terrain = UniformTerrain>
+VariantResult runBasic(const std::string& name, const GridView& grid, const std::vector<PathQuery>& queries) {
+    using PathFinder = BasicAStar<Connectivity, Heuristic, CostT, Terrain>;
+    PathFinder path_finder;
+    TrackingResource memory;
+    typename PathFinder::SearchContext context(&memory);
+
+    VariantResult result;
+    result.name = name;
+    result.hasStats = searchStatsEnabled;
+    for (const PathQuery& query : queries) {
+        Clock::time_point begin = Clock::now();
+        const std::pmr::vector<Point>& path = path_finder.findPath(context, grid, query.start, query.goal);
+        result.micros.push_back(elapsedMicros(begin));
+
+        addQuery(result, context.lastStats(), path);
+    }
+    result.peakBytes = memory.peak();
+    return result;
+}
+
+// The open list AStar had before IndexedHeap: a std::priority_queue that is
+// copied and drained for every neighbor to find out whether it is queued.
+// Quadratic in the open list, so only for small maps; compare with standard.
+VariantResult runPriorityQueue(const GridView& grid, const std::vector<PathQuery>& queries) {
+    struct Node {
+        int index;
+        int g;
+        int f;
+    };
+    struct NodeCompare {
+        bool operator()(const Node& lhs, const Node& rhs) const { return lhs.f > rhs.f; }
+    };
+    using OpenSet = std::priority_queue<Node, std::vector<Node>, NodeCompare>;
+
+    VariantResult result;
+    result.name = "pqueue";
+    for (const PathQuery& query : queries) {
+        Clock::time_point begin = Clock::now();
+        int finishIndex = grid.index(query.goal);
+        auto heuristic = [&](int index) {
+            Point p = grid.point(index);
+            return std::abs(p.x - query.goal.x) + std::abs(p.y - query.goal.y);
+        };
+
+        OpenSet openSet;
+        std::vector<bool> closed(grid.cellCount(), false);
+        std::vector<int> cameFrom(grid.cellCount(), -1);
+        openSet.push({ grid.index(query.start), 0, heuristic(grid.index(query.start)) });
+        std::pmr::vector<Point> path;
+        while (!openSet.empty()) {
+            Node current = openSet.top();
+            openSet.pop();
+            if (current.index == finishIndex) {
+                for (int index = current.index; index != -1; index = cameFrom[index]) {
+                    path.push_back(grid.point(index));
+                }
+                std::reverse(path.begin(), path.end());
+                break;
+            }
+            closed[current.index] = true;
+
+            for (int offset : { grid.stride, -grid.stride, 1, -1 }) {
+                int neighbor = current.index + offset;
+                if (grid.isWall(neighbor) || closed[neighbor]) {
+                    continue;
+                }
+                Node node = { neighbor, current.g + 1, current.g + 1 + heuristic(neighbor) };
+
+                bool found = false;
+                OpenSet openSetCopy = openSet;
+                while (!openSetCopy.empty()) {
+                    if (openSetCopy.top().index == neighbor && node.f >= openSetCopy.top().f) {
+                        found = true;
+                        break;
+                    }
+                    openSetCopy.pop();
+                }
+                if (!found) {
+                    cameFrom[neighbor] = current.index;
+                    openSet.push(node);
+                }
+            }
+        }
+        result.micros.push_back(elapsedMicros(begin));
+
+        result.pathCells += path.size();
+        result.found += path.empty() ? 0 : 1;
+    }
+    return result;
+}
+
+// Landmark tables are built once per map; their expansions compare with standard's.
+VariantResult runLandmarks(const GridView& grid, const std::vector<PathQuery>& queries, int count) {
+    Landmarks landmarks(count);
+
+    Clock::time_point begin = Clock::now();
+    landmarks.build(grid);
+    double buildMillis = elapsedMicros(begin) / 1000.0;
+
+    // what an edit costs: the landmarks stay, every table is refilled
+    begin = Clock::now();
+    landmarks.update(grid);
+    double updateMillis = elapsedMicros(begin) / 1000.0;
+
+    std::printf("alt: %d landmarks, %zu KB of tables, build %.1f ms, update %.1f ms\n",
+        landmarks.count(), landmarks.memoryBytes() / 1024, buildMillis, updateMillis);
+    return runFlat("alt", SearchMode::Landmark, grid, queries, &landmarks);
+}
+
+// The same paths as standard in a fraction of the memory: compare peak(KB) and the times.
+VariantResult runFringe(const GridView& grid, const std::vector<PathQuery>& queries) {
+    TrackingResource memory;
+    FringeSearch search(&memory);
+
+    VariantResult result;
+    result.name = "fringe";
+    result.hasStats = searchStatsEnabled;
+    long long passes = 0;
+    for (const PathQuery& query : queries) {
+        Clock::time_point begin = Clock::now();
+        const std::pmr::vector<Point>& path = search.findPath(grid, query.start, query.goal);
+        result.micros.push_back(elapsedMicros(begin));
+        passes += search.lastPasses();
+
+        addQuery(result, search.lastStats(), path);
+    }
+    result.peakBytes = memory.peak();
+
+    std::printf("fringe: %.1f threshold passes per query, %.1f bytes per cell at peak\n",
+        static_cast<double>(passes) / queries.size(), static_cast<double>(result.peakBytes) / grid.cellCount());
+    return result;
+}
+
+VariantResult runHierarchical(const GridView& grid, const std::vector<PathQuery>& queries, int clusterSize, int edits, unsigned seed) {
+    HPAStar hierarchy(clusterSize);
+
+    Clock::time_point begin = Clock::now();
+    hierarchy.build(grid);
+    double buildMillis = elapsedMicros(begin) / 1000.0;
+
+    VariantResult result;
+    result.name = "hpa";
+    for (const PathQuery& query : queries) {
+        begin = Clock::now();
+        std::vector<Point> path = hierarchy.findPath(grid, query.start, query.goal);
+        result.micros.push_back(elapsedMicros(begin));
+
+        result.pathCells += path.size();
+        result.found += path.empty() ? 0 : 1;
+    }
+
+    // single-cell edits: marking is free, the cost is in rebuilding the clusters
+    std::mt19937 rng(seed);
+    double rebuildMicros = 0.0;
+    for (int i = 0; i < edits; ++i) {
+        int row = rng() % grid.rows;
+        int col = rng() % grid.cols;
+        hierarchy.cellChanged(row, col);
+        begin = Clock::now();
+        hierarchy.update(grid);
+        rebuildMicros += elapsedMicros(begin);
+    }
+
+    std::printf("hpa: %d clusters of %dx%d, build %.1f ms", hierarchy.clusterCount(), clusterSize, clusterSize, buildMillis);
+    if (edits > 0) {
+        std::printf(", %.1f us per single-cell rebuild", rebuildMicros / edits);
+    }
+    std::printf("\n");
+    return result;
+}
+
+std::string perQuery(const VariantResult& result, long long total) {
+    if (!result.hasStats) {
+        return "-";
+    }
+    return std::to_string(total / static_cast<long long>(std::max<size_t>(result.micros.size(), 1)));
+}
+
+// ARA* called with a fixed budget per call, like one per frame, until the
+// path is optimal: how soon the first path shows up and how good it is.
+void runAnytime(const GridView& grid, const std::vector<PathQuery>& queries, double budgetMillis) {
+    ARAStar::Budget budget;
+    budget.maxMillis = budgetMillis;
+
+    int found = 0;
+    long long calls = 0;
+    double firstMicros = 0.0;
+    double firstBound = 0.0;
+    double firstRatio = 0.0;
+    double totalMicros = 0.0;
+    ARAStar search;  // reused like the app does, a new query restarts it
+    for (const PathQuery& query : queries) {
+        double micros = 0.0;
+        double firstCost = 0.0;
+        bool first = true;
+        do {
+            Clock::time_point begin = Clock::now();
+            const std::pmr::vector<Point>& path = search.findPath(grid, query.start, query.goal, budget);
+            micros += elapsedMicros(begin);
+            ++calls;
+
+            if (first && !path.empty()) {
+                first = false;
+                firstMicros += micros;
+                firstBound += search.bound();
+                firstCost = search.lastCost();
+            }
+        } while (!search.isFinished());
+
+        totalMicros += micros;
+        if (!first) {
+            ++found;
+            firstRatio += firstCost / search.lastCost();
+        }
+    }
+
+    std::printf("anytime: %.1f ms per call, %.1f calls per query, %.1f us in total per query\n",
+        budgetMillis, static_cast<double>(calls) / queries.size(), totalMicros / queries.size());
+    if (found > 0) {
+        std::printf("anytime: first path after %.1f us, bound %.2f, actually %.3f x optimal (mean of %d)\n",
+            firstMicros / found, firstBound / found, firstRatio / found, found);
+    }
+}
+
+// Heavy edit load on a PathService: wall toggles at a fixed rate on the
+// editing thread, a renderer thread polling for paths every millisecond, and
+// the latency from each edit to the first published path that includes it.
+void runAsync(const GridView& grid, const PathQuery& query, int edits, double rate, unsigned seed) {
+    PathService service(grid);
+    service.setEndpoints(query.start, query.goal);
+
+    std::atomic<bool> editing{ true };
+    std::vector<double> seen;  // latencies of the results the renderer picked up
+    std::thread renderer([&service, &editing, &seen] {
+        while (editing.load()) {
+            if (service.hasNewResult()) {
+                seen.push_back(service.latest().latencyMicros);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    std::mt19937 rng(seed);
+    Clock::time_point next = Clock::now();
+    auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+    for (int i = 0; i < edits; ++i) {
+        int row = rng() % grid.rows;
+        int col = rng() % grid.cols;
+        if (Point(row, col) == query.start || Point(row, col) == query.goal) {
+            continue;
+        }
+        service.setCell(row, col, rng() % 2 == 0 ? CELL_WALL : 0);
+
+        next += interval;
+        std::this_thread::sleep_until(next);
+    }
+
+    Clock::time_point begin = Clock::now();
+    bool settled = service.waitFor(service.version(), std::chrono::milliseconds(60000));
+    double settleMillis = elapsedMicros(begin) / 1000.0;
+    editing = false;
+    renderer.join();
+
+    PathService::Statistics statistics = service.statistics();
+    std::sort(seen.begin(), seen.end());
+    std::printf("async: %d edits at %.0f/s, %llu searches started, %llu cancelled, %llu published, %llu grid copies\n",
+        edits, rate, statistics.started, statistics.cancelled, statistics.published, statistics.snapshotCopies);
+    std::printf("async: edit to published path %.0f us mean, %.0f us max; as seen by the renderer p50 %.0f us, p99 %.0f us\n",
+        statistics.meanLatencyMicros, statistics.maxLatencyMicros, percentile(seen, 0.5), percentile(seen, 0.99));
+    if (settled) {
+        std::printf("async: last edit answered %.2f ms after the edit stream stopped\n", settleMillis);
+    }
+    else {
+        std::printf("async: no path for the last edit within 60 s\n");
+    }
+}
+
+// Full repaint against per-edit and per-path-change frames of the dirty-cell
+// renderer; the latter should not depend on the map size.
+void runRender(const GridView& map, const std::vector<PathQuery>& queries, int edits, unsigned seed, const std::string& ppmFile) {
+    GridStorage grid(map);  // edited below
+
+    // a few pixels per cell, at most about 2048 pixels a side
+    int pitch = std::max(1, std::min(8, 2048 / std::max(grid.getRows(), grid.getCols())));
+    int spacing = pitch >= 4 ? 1 : 0;
+    GridRenderer::Palette palette;
+    palette.cells.assign(256, rgbColor(67, 65, 65));
+    palette.cells[CELL_WALL] = rgbColor(255, 0, 0);
+    for (int value = CELL_TERRAIN; value < 256; ++value) {
+        int dark = std::min(cellCost(static_cast<uint8_t>(value)) * 6, 60);
+        palette.cells[value] = rgbColor(140 - dark, 110 - dark, 70 - dark);
+    }
+    GridRenderer renderer(grid.getRows(), grid.getCols(), pitch - spacing, spacing, palette);
+
+    Clock::time_point begin = Clock::now();
+    renderer.render(grid.view());
+    double firstMillis = elapsedMicros(begin) / 1000.0;
+    begin = Clock::now();
+    renderer.invalidateAll();
+    renderer.render(grid.view());
+    double fullMillis = elapsedMicros(begin) / 1000.0;
+
+    // toggle random cells, one per frame, like painting walls in the app
+    std::mt19937 rng(seed);
+    double editMicros = 0.0;
+    size_t editRects = 0;
+    for (int i = 0; i < edits; ++i) {
+        int row = rng() % grid.getRows();
+        int col = rng() % grid.getCols();
+        grid.set(row, col, grid.get(row, col) == CELL_WALL ? 0 : CELL_WALL);
+
+        begin = Clock::now();
+        renderer.cellChanged(row, col);
+        editRects += renderer.render(grid.view()).size();
+        editMicros += elapsedMicros(begin);
+    }
+
+    // paths of consecutive queries, as when the path moves after an edit
+    AStar path_finder;
+    AStar::SearchContext context;
+    double pathMicros = 0.0;
+    size_t pathRepainted = 0;
+    size_t pathCells = 0;
+    for (const PathQuery& query : queries) {
+        const std::pmr::vector<Point>& found = path_finder.findPath(context, grid.view(), query.start, query.goal);
+        std::vector<Point> path(found.begin(), found.end());
+        pathCells += path.size();
+
+        begin = Clock::now();
+        renderer.setPath(path);
+        renderer.render(grid.view());
+        pathMicros += elapsedMicros(begin);
+        pathRepainted += renderer.lastRepainted();
+    }
+
+    const FrameBuffer& frame = renderer.frame();
+    std::printf("render: %dx%d px frame, first frame %.2f ms, full repaint %.2f ms\n",
+        frame.width(), frame.height(), firstMillis, fullMillis);
+    if (edits > 0) {
+        std::printf("render: %.2f us per single-edit frame, %.2f rects copied\n", editMicros / edits, static_cast<double>(editRects) / edits);
+    }
+    std::printf("render: %.2f us per path change, %.0f cells repainted for paths of %.0f cells on average\n",
+        pathMicros / queries.size(), static_cast<double>(pathRepainted) / queries.size(), static_cast<double>(pathCells) / queries.size());
+
+    if (!ppmFile.empty()) {
+        frame.savePPM(ppmFile);
+        std::printf("render: last frame saved to %s\n", ppmFile.c_str());
+    }
+}
+
+// Labeling cost, per-edit maintenance cost and what the O(1) check saves on
+// queries without a path.
+void runComponents(const GridView& map, const std::vector<PathQuery>& queries, int edits, unsigned seed) {
+    GridStorage grid(map);  // edited below
+    ComponentIndex index;
+
+    Clock::time_point begin = Clock::now();
+    index.build(grid.view());
+    double buildMillis = elapsedMicros(begin) / 1000.0;
+    int built = index.componentCount();
+
+    AStar path_finder;
+    AStar::SearchContext context;
+    int unreachable = 0;
+    double searchMicros = 0.0;
+    double checkMicros = 0.0;
+    for (const PathQuery& query : queries) {
+        begin = Clock::now();
+        bool connected = index.connected(grid.view(), query.start, query.goal);
+        checkMicros += elapsedMicros(begin);
+        if (connected) {
+            continue;
+        }
+
+        ++unreachable;
+        begin = Clock::now();
+        path_finder.findPath(context, grid.view(), query.start, query.goal);
+        searchMicros += elapsedMicros(begin);
+    }
+
+    // toggle random cells, like painting walls in the app
+    std::mt19937 rng(seed);
+    double editMicros = 0.0;
+    for (int i = 0; i < edits; ++i) {
+        int row = rng() % grid.getRows();
+        int col = rng() % grid.getCols();
+        bool wasWall = grid.get(row, col) == CELL_WALL;
+        grid.set(row, col, wasWall ? 0 : CELL_WALL);
+
+        begin = Clock::now();
+        if (wasWall) {
+            index.cellOpened(grid.view(), row, col);
+        }
+        else {
+            index.cellBlocked(grid.view(), row, col);
+        }
+        editMicros += elapsedMicros(begin);
+    }
+
+    std::printf("components: %d, build %.1f ms", built, buildMillis);
+    if (edits > 0) {
+        std::printf(", %.2f us per edit (%lld cells relabeled)", editMicros / edits, index.relabeledCells());
+    }
+    std::printf("\n");
+    if (unreachable > 0) {
+        std::printf("components: %d unreachable queries, search %.1f us vs check %.3f us on average\n",
+            unreachable, searchMicros / unreachable, checkMicros / queries.size());
+    }
+}
+
+void printResults(const std::vector<VariantResult>& results) {
+    std::printf("\n%-14s %7s %10s %10s %10s %10s %10s %10s %10s %7s %7s %10s %10s %10s\n",
+        "variant", "found", "mean(us)", "p50(us)", "p90(us)", "p99(us)", "max(us)",
+        "expanded", "pushed", "stale", "reopen", "peak open", "cells", "peak(KB)");
+
+    for (const VariantResult& result : results) {
+        std::vector<double> sorted = result.micros;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (double micros : sorted) {
+            total += micros;
+        }
+        double mean = sorted.empty() ? 0.0 : total / sorted.size();
+
+        std::string peakOpen = result.hasStats ? std::to_string(result.peakOpenSize) : "-";
+        std::string peak = result.peakBytes == 0 ? "-" : std::to_string(result.peakBytes / 1024);
+        std::printf("%-14s %7d %10.1f %10.1f %10.1f %10.1f %10.1f %10s %10s %7s %7s %10s %10lld %10s\n",
+            result.name.c_str(), result.found, mean,
+            percentile(sorted, 0.5), percentile(sorted, 0.9), percentile(sorted, 0.99), sorted.empty() ? 0.0 : sorted.back(),
+            perQuery(result, result.expanded).c_str(), perQuery(result, result.pushed).c_str(),
+            perQuery(result, result.stalePops).c_str(), perQuery(result, result.reopenings).c_str(),
+            peakOpen.c_str(), result.pathCells, peak.c_str());
+    }
+    std::printf("(expanded, pushed, stale and reopen are per query, peak open is the largest open list,\n"
+        " cells is the total path length)\n");
+}
+
+// Every query start is an agent heading for the first query's goal: one field
+// build per thread count, then each agent follows the arrows, compared with a
+// weighted A* per agent (same terrain costs, so the path costs match).
+void runFlowField(const GridView& map, const std::vector<PathQuery>& queries, const std::vector<std::string>& threadCounts, int edits, unsigned seed) {
+    GridStorage grid(map);  // edited below
+    Point goal = queries.front().goal;
+
+    std::printf("\n%-8s %12s %8s %10s\n", "threads", "build(ms)", "rounds", "tile runs");
+    FlowField field;
+    for (const std::string& count : threadCounts) {
+        field = FlowField(static_cast<unsigned>(std::stoi(count)));
+        field.build(grid.view(), goal);  // starts the workers
+
+        Clock::time_point begin = Clock::now();
+        field.build(grid.view(), goal);
+        std::printf("%-8u %12.2f %8d %10d\n", field.threadCount(), elapsedMicros(begin) / 1000.0, field.lastRounds(), field.lastTileRuns());
+    }
+
+    double followMicros = 0.0;
+    long long followCells = 0;
+    for (const PathQuery& query : queries) {
+        Clock::time_point begin = Clock::now();
+        std::vector<Point> path = field.pathFrom(query.start);
+        followMicros += elapsedMicros(begin);
+        followCells += static_cast<long long>(path.size());
+    }
+
+    AStar path_finder;
+    AStar::SearchContext context;
+    double searchMicros = 0.0;
+    long long searchCells = 0;
+    for (const PathQuery& query : queries) {
+        Clock::time_point begin = Clock::now();
+        const std::pmr::vector<Point>& path = path_finder.findPath(context, grid.view(), query.start, goal, SearchMode::Weighted);
+        searchMicros += elapsedMicros(begin);
+        searchCells += static_cast<long long>(path.size());
+    }
+
+    std::printf("flowfield: %zu agents, follow %.2f us vs weighted A* %.1f us per agent (%lld vs %lld cells)\n",
+        queries.size(), followMicros / queries.size(), searchMicros / queries.size(), followCells, searchCells);
+
+    // toggle random cells, like painting walls in the app
+    std::mt19937 rng(seed);
+    double editMicros = 0.0;
+    long long tileRuns = 0;
+    for (int i = 0; i < edits; ++i) {
+        int row = rng() % grid.getRows();
+        int col = rng() % grid.getCols();
+        grid.set(row, col, grid.get(row, col) == CELL_WALL ? 0 : CELL_WALL);
+
+        Clock::time_point begin = Clock::now();
+        field.cellChanged(row, col);
+        field.update(grid.view());
+        editMicros += elapsedMicros(begin);
+        tileRuns += field.lastTileRuns();
+    }
+    if (edits > 0) {
+        std::printf("flowfield: %.1f us per single-cell update, %.1f tile runs each\n", editMicros / edits, static_cast<double>(tileRuns) / edits);
+    }
+}
+
+// Independent A* per agent, which lets agents run into each other, against
+// WHCA*, which does not, for growing numbers of agents on the same map.
+void runAgents(const GridView& grid, const std::vector<std::string>& agentCounts, int window, unsigned seed) {
+    std::vector<int> freeCells;
+    for (int row = 0; row < grid.rows; ++row) {
+        for (int col = 0; col < grid.cols; ++col) {
+            if (grid.at(Point(row, col)) != CELL_WALL) {
+                freeCells.push_back(grid.index(Point(row, col)));
+            }
+        }
+    }
+    ComponentIndex components;
+    components.build(grid);
+
+    std::printf("\n%-7s %10s %11s %10s %10s %9s %9s %9s %8s %8s\n",
+        "agents", "indep(ms)", "collisions", "whca(ms)", "ms/step", "arrived", "makespan", "sum", "failed", "held");
+    for (const std::string& count : agentCounts) {
+        // distinct starts and distinct goals, each pair connected
+        std::mt19937 rng(seed);
+        std::vector<int> starts = freeCells;
+        std::vector<int> goals = freeCells;
+        std::shuffle(starts.begin(), starts.end(), rng);
+        std::shuffle(goals.begin(), goals.end(), rng);
+        std::vector<Point> from;
+        std::vector<Point> to;
+        size_t wanted = static_cast<size_t>(std::stoi(count));
+        for (size_t i = 0; i < freeCells.size() && from.size() < wanted; ++i) {
+            Point start = grid.point(starts[i]);
+            Point goal = grid.point(goals[i]);
+            if (components.connected(grid, start, goal)) {
+                from.push_back(start);
+                to.push_back(goal);
+            }
+        }
+
+        // every agent follows its own shortest path and then waits at its goal
+        AStar path_finder;
+        AStar::SearchContext context;
+        std::vector<std::vector<int>> paths;
+        size_t longest = 0;
+        Clock::time_point begin = Clock::now();
+        for (size_t i = 0; i < from.size(); ++i) {
+            const std::pmr::vector<Point>& path = path_finder.findPath(context, grid, from[i], to[i]);
+            paths.emplace_back();
+            for (const Point& p : path) {
+                paths.back().push_back(grid.index(p));
+            }
+            longest = std::max(longest, path.size());
+        }
+        double independentMillis = elapsedMicros(begin) / 1000.0;
+
+        long long collisions = 0;
+        std::unordered_map<int, size_t> occupant;
+        auto cellAt = [&paths](size_t agent, size_t time) {
+            return paths[agent][std::min(time, paths[agent].size() - 1)];
+        };
+        for (size_t time = 0; time < longest; ++time) {
+            occupant.clear();
+            for (size_t agent = 0; agent < paths.size(); ++agent) {
+                if (!occupant.emplace(cellAt(agent, time), agent).second) {
+                    ++collisions;
+                }
+            }
+            if (time == 0) {
+                continue;
+            }
+            for (size_t agent = 0; agent < paths.size(); ++agent) {
+                auto other = occupant.find(cellAt(agent, time - 1));
+                if (other != occupant.end() && other->second > agent && cellAt(agent, time) != cellAt(agent, time - 1)
+                    && cellAt(other->second, time - 1) == cellAt(agent, time)) {
+                    ++collisions;  // swapped places
+                }
+            }
+        }
+
+        CooperativePlanner planner(window);
+        planner.reset(grid, from, to);
+        // gives up once no agent arrived for longer than any route takes alone:
+        // in mazes that means the rest are deadlocked
+        int maxSteps = static_cast<int>(longest) * 4 + 100;
+        size_t arrived = 0;
+        size_t mostArrived = 0;
+        int lastGain = 0;
+        long long arrivalSum = 0;
+        while (!planner.allArrived() && planner.time() < maxSteps && planner.time() - lastGain <= static_cast<int>(longest) + window) {
+            planner.step();
+            arrived = 0;
+            for (size_t i = 0; i < planner.agentCount(); ++i) {
+                arrived += planner.arrivalTime(static_cast<int>(i)) >= 0;
+            }
+            if (arrived > mostArrived) {
+                mostArrived = arrived;
+                lastGain = planner.time();
+            }
+        }
+        arrived = 0;
+        for (size_t i = 0; i < planner.agentCount(); ++i) {
+            if (planner.arrivalTime(static_cast<int>(i)) >= 0) {
+                arrivalSum += planner.arrivalTime(static_cast<int>(i));
+                ++arrived;
+            }
+        }
+
+        const CooperativePlanner::Statistics& stats = planner.statistics();
+        std::printf("%-7zu %10.1f %11lld %10.1f %10.3f %9s %9d %9lld %8llu %8llu\n",
+            from.size(), independentMillis, collisions, stats.planMicros / 1000.0, stats.planMicros / 1000.0 / std::max(planner.time(), 1),
+            (std::to_string(arrived) + "/" + std::to_string(from.size())).c_str(),
+            planner.allArrived() ? planner.time() : -1, arrivalSum, stats.failedSearches, stats.heldBack);
+    }
+}
+
+// One query at a time spread over threads, against standard on one thread:
+// what it does to the latency of single long queries.
+void runParallel(const GridView& grid, const std::vector<PathQuery>& queries, const std::vector<std::string>& threadCounts) {
+    AStar path_finder;
+    AStar::SearchContext context;
+    std::vector<double> baseline;
+    long long baselineExpanded = 0;
+    for (const PathQuery& query : queries) {
+        Clock::time_point begin = Clock::now();
+        path_finder.findPath(context, grid, query.start, query.goal);
+        baseline.push_back(elapsedMicros(begin));
+        baselineExpanded += context.lastStats().expanded;
+    }
+    std::sort(baseline.begin(), baseline.end());
+
+    std::printf("\n%-8s %10s %10s %10s %10s %10s %10s %9s\n", "threads", "mean(us)", "p50(us)", "p99(us)", "max(us)", "expanded", "batches", "p99 gain");
+    auto printRow = [&](const std::string& name, std::vector<double> micros, long long expanded, unsigned long long sent) {
+        std::sort(micros.begin(), micros.end());
+        double total = 0.0;
+        for (double value : micros) {
+            total += value;
+        }
+        std::printf("%-8s %10.1f %10.1f %10.1f %10.1f %10lld %10llu %8.2fx\n", name.c_str(), total / micros.size(),
+            percentile(micros, 0.5), percentile(micros, 0.99), micros.back(), expanded / static_cast<long long>(micros.size()),
+            sent / micros.size(), percentile(baseline, 0.99) / percentile(micros, 0.99));
+    };
+    printRow("standard", baseline, baselineExpanded, 0);
+
+    for (const std::string& count : threadCounts) {
+        ParallelAStar search(static_cast<unsigned>(std::stoi(count)));
+        std::vector<double> micros;
+        long long expanded = 0;
+        unsigned long long sent = 0;
+        size_t mismatches = 0;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            Clock::time_point begin = Clock::now();
+            const std::vector<Point>& path = search.findPath(grid, queries[i].start, queries[i].goal);
+            micros.push_back(elapsedMicros(begin));
+            expanded += search.lastStats().expanded;
+            sent += search.lastBatches();
+
+            mismatches += path.size() != path_finder.findPath(context, grid, queries[i].start, queries[i].goal).size();
+        }
+        printRow(std::to_string(search.threadCount()), micros, expanded, sent);
+        if (mismatches > 0) {
+            std::printf("  %zu paths differ in length from standard\n", mismatches);
+        }
+    }
+    std::printf("(expanded and batches are per query; every thread past the cores' count only adds overhead)\n");
+}
+
+// The map written as tiles to a scratch file and searched through tile caches
+// of each budget, against the same queries on the map in memory.
+void runPaged(const GridView& grid, const std::vector<PathQuery>& queries, const std::vector<std::string>& cacheKilobytes, int tileSize) {
+    std::string path = (std::filesystem::temp_directory_path() / "astar-bench.tiles").string();
+    TiledGrid::save(path, grid, tileSize);
+
+    AStar path_finder;
+    AStar::SearchContext context;
+    std::vector<double> baseline;
+    for (const PathQuery& query : queries) {
+        Clock::time_point begin = Clock::now();
+        path_finder.findPath(context, grid, query.start, query.goal);
+        baseline.push_back(elapsedMicros(begin));
+    }
+    std::sort(baseline.begin(), baseline.end());
+
+    std::printf("\n%-10s %8s %10s %10s %10s %9s %10s %10s\n", "cache(KB)", "tiles", "mean(us)", "p50(us)", "p99(us)", "hit rate", "page-ins", "evictions");
+    double total = 0.0;
+    for (double micros : baseline) {
+        total += micros;
+    }
+    std::printf("%-10s %8s %10.1f %10.1f %10.1f %9s %10s %10s\n", "in memory", "-", total / baseline.size(),
+        percentile(baseline, 0.5), percentile(baseline, 0.99), "-", "-", "-");
+
+    for (const std::string& kilobytes : cacheKilobytes) {
+        TiledGrid tiled(path, static_cast<size_t>(std::stoul(kilobytes)) * 1024);
+        TiledGridView view = tiled.view();
+
+        std::vector<double> micros;
+        size_t mismatches = 0;
+        for (const PathQuery& query : queries) {
+            Clock::time_point begin = Clock::now();
+            size_t length = path_finder.findPath(context, view, query.start, query.goal).size();
+            micros.push_back(elapsedMicros(begin));
+            mismatches += length != path_finder.findPath(context, grid, query.start, query.goal).size();
+        }
+        std::sort(micros.begin(), micros.end());
+        total = 0.0;
+        for (double value : micros) {
+            total += value;
+        }
+
+        const TileCacheStats& stats = tiled.statistics();
+        std::printf("%-10zu %8d %10.1f %10.1f %10.1f %8.2f%% %10llu %10llu\n", tiled.cacheBytes() / 1024, tiled.capacity(),
+            total / micros.size(), percentile(micros, 0.5), percentile(micros, 0.99), stats.hitRate() * 100.0,
+            stats.pageIns / queries.size(), stats.evictions / queries.size());
+        if (mismatches > 0) {
+            std::printf("  %zu paths differ in length from the map in memory\n", mismatches);
+        }
+    }
+    std::printf("(%dx%d tiles, %d in the map; page-ins and evictions are per query, the hit rate is per cell read)\n",
+        tileSize, tileSize, ((grid.rows + tileSize - 1) / tileSize) * ((grid.cols + tileSize - 1) / tileSize));
+    std::filesystem::remove(path);
+}
+
+void runBatch(const GridView& grid, const std::vector<PathQuery>& queries, const std::vector<std::string>& threadCounts) {
+    std::printf("\n%-8s %12s %10s\n", "threads", "queries/s", "speedup");
+
+    double baseline = 0.0;
+    for (const std::string& count : threadCounts) {
+        BatchPathFinder batch(static_cast<unsigned>(std::stoi(count)));
+        batch.findPaths(grid, queries);  // warm up the per-worker contexts
+
+        Clock::time_point begin = Clock::now();
+        batch.findPaths(grid, queries);
+        double seconds = elapsedMicros(begin) / 1e6;
+
+        double throughput = queries.size() / seconds;
+        if (baseline == 0.0) {
+            baseline = throughput;
+        }
+        std::printf("%-8u %12.0f %9.2fx\n", batch.threadCount(), throughput, throughput / baseline);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    args::ArgumentParser parser("Headless path-finding benchmark on generated or MovingAI maps.");
+
+    args::HelpFlag help(parser, "help", "Display this help menu", { 'h', "help" });
+    args::ValueFlag<std::string> mapKind(parser, "kind", "Generated map: random, maze, rooms, terrain or open (default: random)", { 'm', "map" });
+    args::ValueFlag<std::string> mapFile(parser, "file", "Load a MovingAI .map or a binary grid file instead of generating a map", { 'f', "file" });
+    args::ValueFlag<std::string> scenFile(parser, "scen", "Take the queries from a MovingAI .scen file", { "scen" });
+    args::ValueFlag<std::string> saveFile(parser, "save", "Write the map as a binary grid file and exit", { "save" });
+    args::ValueFlag<int> rows(parser, "rows", "Number of rows (default: 1000)", { 'r', "rows" });
+    args::ValueFlag<int> cols(parser, "cols", "Number of columns (default: 1000)", { 'c', "cols" });
+    args::ValueFlag<double> density(parser, "density", "Wall density of random maps (default: 0.2)", { 'd', "density" });
+    args::ValueFlag<unsigned> seed(parser, "seed", "Seed for map and queries (default: 1)", { 's', "seed" });
+    args::ValueFlag<int> queryCount(parser, "queries", "Number of start/goal queries (default: 200, or the whole --scen file)", { 'q', "queries" });
+    args::ValueFlag<std::string> variants(parser, "variants", "Comma separated: standard,pqueue,jps,bidir,weighted,fringe,alt,weighted-heap,octile,octile-f,euclid,hpa,anytime,async,components,flowfield,parallel,paged,batch,render,agents (default: all but pqueue)", { 'a', "algorithms" });
+    args::ValueFlag<std::string> agentCounts(parser, "agents", "Agent counts for agents (default: 10,30,100,300,1000)", { "agents" });
+    args::ValueFlag<int> window(parser, "window", "WHCA* window in steps for agents (default: 16)", { "window" });
+    args::ValueFlag<std::string> threads(parser, "threads", "Thread counts for flowfield, parallel and batch (default: 1,2,4,8,16)", { 't', "threads" });
+    args::ValueFlag<int> landmarkCount(parser, "landmarks", "Landmarks for alt (default: 16)", { "landmarks" });
+    args::ValueFlag<std::string> cacheSizes(parser, "cache", "Tile cache budgets in KB for paged (default: 64,256,1024,4096)", { "cache" });
+    args::ValueFlag<int> tileSize(parser, "tile", "Tile size of paged, a power of two from 8 to 4096 (default: 64)", { "tile" });
+    args::ValueFlag<int> clusterSize(parser, "cluster", "HPA* cluster size (default: 16)", { "cluster" });
+    args::ValueFlag<double> budget(parser, "budget", "Milliseconds per anytime call (default: 1)", { "budget" });
+    args::ValueFlag<int> edits(parser, "edits", "Single-cell edits to time for hpa, async, components, flowfield and render (default: 100)", { "edits" });
+    args::ValueFlag<double> editRate(parser, "rate", "Edits per second for async (default: 1000)", { "rate" });
+    args::ValueFlag<std::string> ppmFile(parser, "ppm", "Save the last frame of render as a PPM image", { "ppm" });
+
+    try {
+        parser.ParseCLI(argc, argv);
+    }
+    catch (args::Help&) {
+        std::cout << parser;
+        return 0;
+    }
+    catch (args::ParseError& e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    unsigned mapSeed = seed ? *seed : 1;
+    GridStorage storage;
+    GridFile mapped;  // searched in place, never copied
+    GridView grid;
+    try {
+        Clock::time_point begin = Clock::now();
+        if (mapFile && GridFile::isGridFile(*mapFile)) {
+            mapped = GridFile(*mapFile);
+            grid = mapped.view();
+            std::printf("map: %s (mapped in %.2f ms)", mapFile->c_str(), elapsedMicros(begin) / 1000.0);
+        }
+        else if (mapFile) {
+            storage = loadMovingAIMap(*mapFile);
+            grid = storage.view();
+            std::printf("map: %s (parsed in %.2f ms)", mapFile->c_str(), elapsedMicros(begin) / 1000.0);
+        }
+        else {
+            std::string kindName = mapKind ? *mapKind : "random";
+            MapKind kind;
+            if (!parseMapKind(kindName, kind)) {
+                std::cerr << "Unknown map kind: " << kindName << std::endl;
+                return 1;
+            }
+            double mapDensity = density ? *density : 0.2;
+            storage = generateMap(kind, rows ? *rows : 1000, cols ? *cols : 1000, mapSeed, mapDensity);
+            grid = storage.view();
+            std::printf("map: %s, seed %u", kindName.c_str(), mapSeed);
+        }
+
+        if (saveFile) {
+            GridFile::save(*saveFile, grid);
+            std::printf(", %dx%d, saved to %s\n", grid.rows, grid.cols, saveFile->c_str());
+            return 0;
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<PathQuery> queries;
+    if (scenFile) {
+        try {
+            for (const ScenarioEntry& entry : loadMovingAIScenario(*scenFile)) {
+                if (grid.contains(entry.start) && grid.contains(entry.goal)) {
+                    queries.push_back({ entry.start, entry.goal });
+                }
+            }
+        }
+        catch (std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        if (queryCount && static_cast<size_t>(*queryCount) < queries.size()) {
+            queries.resize(*queryCount);
+        }
+    }
+    else {
+        queries = makeQueries(grid, queryCount ? *queryCount : 200, mapSeed + 1);
+    }
+    std::printf(", %dx%d, %zu queries\n", grid.rows, grid.cols, queries.size());
+    if (queries.empty()) {
+        std::cerr << (scenFile ? "The scenario has no queries on this map" : "The map has no free cells") << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> selected = splitList(variants ? *variants : "standard,jps,bidir,weighted,fringe,alt,weighted-heap,octile,octile-f,euclid,hpa,anytime,async,components,flowfield,parallel,paged,batch,render,agents");
+    auto wants = [&selected](const char* name) { return std::find(selected.begin(), selected.end(), name) != selected.end(); };
+
+    std::vector<VariantResult> results;
+    if (wants("standard")) {
+        results.push_back(runFlat("standard", SearchMode::Standard, grid, queries));
+    }
+    if (wants("pqueue")) {
+        results.push_back(runPriorityQueue(grid, queries));
+    }
+    if (wants("jps")) {
+        results.push_back(runFlat("jps", SearchMode::JumpPoint, grid, queries));
+    }
+    if (wants("bidir")) {
+        results.push_back(runFlat("bidir", SearchMode::Bidirectional, grid, queries));
+    }
+    if (wants("weighted")) {
+        results.push_back(runFlat("weighted", SearchMode::Weighted, grid, queries));
+    }
+    if (wants("fringe")) {
+        results.push_back(runFringe(grid, queries));
+    }
+    if (wants("alt")) {
+        results.push_back(runLandmarks(grid, queries, landmarkCount ? *landmarkCount : 16));
+    }
+    if (wants("weighted-heap")) {
+        results.push_back(runBasic<FourConnected, ManhattanDistance, int, WeightedTerrain>("weighted-heap", grid, queries));
+    }
+    if (wants("octile")) {
+        results.push_back(runBasic<EightConnected, OctileDistance, int>("octile", grid, queries));
+    }
+    if (wants("octile-f")) {
+        results.push_back(runBasic<EightConnected, OctileDistance, double>("octile-f", grid, queries));
+    }
+    if (wants("euclid")) {
+        results.push_back(runBasic<EightConnected, EuclideanDistance, int>("euclid", grid, queries));
+    }
+    if (wants("hpa")) {
+        results.push_back(runHierarchical(grid, queries, clusterSize ? *clusterSize : 16, edits ? *edits : 100, mapSeed + 2));
+    }
+
+    if (wants("anytime")) {
+        runAnytime(grid, queries, budget ? *budget : 1.0);
+    }
+    if (wants("async")) {
+        runAsync(grid, queries.front(), edits ? *edits : 100, editRate ? *editRate : 1000.0, mapSeed + 5);
+    }
+    if (wants("components")) {
+        runComponents(grid, queries, edits ? *edits : 100, mapSeed + 3);
+    }
+    if (wants("render")) {
+        try {
+            runRender(grid, queries, edits ? *edits : 100, mapSeed + 6, ppmFile ? *ppmFile : "");
+        }
+        catch (std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!results.empty()) {
+        printResults(results);
+    }
+    if (wants("flowfield")) {
+        runFlowField(grid, queries, splitList(threads ? *threads : "1,2,4,8,16"), edits ? *edits : 100, mapSeed + 4);
+    }
+    if (wants("parallel")) {
+        runParallel(grid, queries, splitList(threads ? *threads : "1,2,4,8,16"));
+    }
+    if (wants("paged")) {
+        try {
+            runPaged(grid, queries, splitList(cacheSizes ? *cacheSizes : "64,256,1024,4096"), tileSize ? *tileSize : TiledGrid::defaultTileSize);
+        }
+        catch (std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+    if (wants("batch")) {
+        runBatch(grid, queries, splitList(threads ? *threads : "1,2,4,8,16"));
+    }
+    if (wants("agents")) {
+        runAgents(grid, splitList(agentCounts ? *agentCounts : "10,30,100,300,1000"), window ? *window : 16, mapSeed + 7);
+    }
+
+    std::printf("\nprocess peak memory: %zu KB\n", peakProcessMemory() / 1024);
+    return 0;
+}
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include "ARAStar.h"
+
+ARAStar::ARAStar(double initialWeight, double weightStep)
+    : initialWeight(std::max(initialWeight, 1.0)), weightStep(weightStep > 0.0 ? weightStep : 1.0), openSet(0) {}
+
+int ARAStar::heuristic(int index) const {
+    // Manhattan distance: every step costs at least 1
+    return abs(index / stride - goalIndex / stride) + abs(index % stride - goalIndex % stride);
+}
+
+ARAStar::Key ARAStar::key(int index) const {
+    int h = heuristic(index);
+    return { g(index) + currentWeight * h, h };
+}
+
+ARAStar::Cell& ARAStar::cell(int index) {
+    Cell& current = cells[index];
+    if (current.generation != generation) {
+        current = Cell();
+        current.generation = generation;
+    }
+    return current;
+}
+
+int ARAStar::g(int index) const {
+    return cells[index].generation == generation ? cells[index].g : infinity;
+}
+
+void ARAStar::initialize(const GridView& grid, const Point& newStart, const Point& newGoal) {
+    rows = grid.rows;
+    cols = grid.cols;
+    stride = grid.stride;
+    start = newStart;
+    goal = newGoal;
+    startIndex = grid.index(start);
+    goalIndex = grid.index(goal);
+
+    size_t count = static_cast<size_t>(grid.cellCount());
+    if (cells.size() != count || ++generation == 0) {
+        // new grid size or stamp wrap-around: the only time cells are touched
+        cells.assign(count, Cell());
+        generation = 1;
+    }
+    incons.clear();
+    openSet.resize(count);
+    pass = 1;
+
+    currentWeight = initialWeight;
+    completedWeight = 0.0;
+    finished = false;
+    path.clear();
+    pathCost = infinity;
+    pathBound = std::numeric_limits<double>::infinity();
+
+    cell(startIndex).g = 0;
+    openSet.push(startIndex, key(startIndex));
+    recorder.pushed(openSet.size());
+    initialized = true;
+}
+
+bool ARAStar::improvePath(const GridView& grid, const Budget& budget, int& expansions, std::chrono::steady_clock::time_point begin) {
+    // a pass is done once no open cell could lead to a cheaper goal at this weight
+    while (!openSet.empty() && g(goalIndex) > openSet.topKey().f) {
+        if (budget.maxExpansions > 0 && expansions >= budget.maxExpansions) {
+            return false;
+        }
+        if (budget.maxMillis > 0.0 && expansions % 64 == 0 && expansions > 0
+            && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() >= budget.maxMillis) {
+            return false;
+        }
+
+        int current = openSet.pop();
+        recorder.expanded(grid, current);
+        ++expansions;
+        cells[current].closedPass = pass;
+        int currentG = cells[current].g;
+
+        for (int offset : { 1, -1, stride, -stride }) {
+            int neighbor = current + offset;
+            if (grid.isWall(neighbor)) {
+                continue;
+            }
+
+            int neighborG = currentG + grid.cost(neighbor);
+            Cell& next = cell(neighbor);
+            if (neighborG >= next.g) {
+                continue;
+            }
+
+            next.g = neighborG;
+            next.parent = current;
+            if (next.closedPass != pass) {
+                openSet.pushOrDecrease(neighbor, key(neighbor));
+                recorder.pushed(openSet.size());
+            }
+            else if (!next.inconsistent) {
+                // expanded in this pass already: it waits for the next one
+                next.inconsistent = true;
+                incons.push_back(neighbor);
+            }
+        }
+    }
+    return true;
+}
+
+void ARAStar::nextPass() {
+    completedWeight = currentWeight;
+    currentWeight = std::max(1.0, currentWeight - weightStep);
+
+    // the open list and the cells improved after their expansion, rekeyed for
+    // the lower weight; closed cells become expandable again
+    scratch.clear();
+    for (size_t i = 0; i < openSet.size(); ++i) {
+        scratch.push_back(openSet.idAt(i));
+    }
+    openSet.clear();
+    for (int index : scratch) {
+        openSet.push(index, key(index));
+    }
+    for (int index : incons) {
+        cells[index].inconsistent = false;
+        if (!openSet.contains(index)) {
+            openSet.push(index, key(index));
+            recorder.reopened();
+        }
+    }
+    incons.clear();
+    recorder.pushed(openSet.size());
+    ++pass;
+}
+
+double ARAStar::lowerBound() const {
+    // Some cell of every optimal path is open or inconsistent with its
+    // optimal g, so the smallest unweighted f among them bounds the optimum.
+    int best = infinity;
+    for (size_t i = 0; i < openSet.size(); ++i) {
+        int index = openSet.idAt(i);
+        best = std::min(best, cells[index].g + heuristic(index));
+    }
+    for (int index : incons) {
+        best = std::min(best, cells[index].g + heuristic(index));
+    }
+    return best;
+}
+
+void ARAStar::extractPath(const GridView& grid) {
+    path.clear();
+    pathCost = g(goalIndex);
+    if (pathCost >= infinity) {
+        return;
+    }
+
+    for (int current = goalIndex; current != -1; current = cells[current].parent) {
+        path.push_back(grid.point(current));
+    }
+    std::reverse(path.begin(), path.end());
+
+    // parents only ever improve, so walking them can only be cheaper than g
+    pathCost = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        pathCost += grid.cost(grid.index(path[i]));
+    }
+}
+
+const std::pmr::vector<Point>& ARAStar::findPath(const GridView& grid, const Point& newStart, const Point& newGoal, const Budget& budget) {
+    recorder.begin();
+    if (!grid.contains(newStart) || !grid.contains(newGoal)) {
+        initialized = false;
+        path.clear();
+        pathCost = infinity;
+        pathBound = std::numeric_limits<double>::infinity();
+        recorder.end();
+        return path;
+    }
+
+    bool sameProblem = initialized
+        && rows == grid.rows && cols == grid.cols
+        && start == newStart && goal == newGoal;
+    if (!sameProblem) {
+        initialize(grid, newStart, newGoal);
+    }
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    int expansions = 0;
+    while (!finished) {
+        if (!improvePath(grid, budget, expansions, begin)) {
+            break;  // out of budget, the pass goes on next call
+        }
+        if (currentWeight <= 1.0 || g(goalIndex) >= infinity) {
+            // the unweighted pass is done, or the goal cannot be reached at all
+            completedWeight = currentWeight;
+            finished = true;
+            break;
+        }
+        nextPass();
+    }
+
+    if (g(goalIndex) < pathCost || path.empty()) {
+        extractPath(grid);
+    }
+    if (path.empty()) {
+        pathBound = std::numeric_limits<double>::infinity();
+    }
+    else if (finished) {
+        pathBound = 1.0;
+    }
+    else {
+        double bound = pathCost / lowerBound();
+        if (completedWeight > 0.0) {
+            bound = std::min(bound, completedWeight);
+        }
+        pathBound = std::max(bound, 1.0);
+    }
+
+    recorder.end();
+    return path;
+}
@@ -0,0 +1,114 @@
+#ifndef ARASTAR_H
+#define ARASTAR_H
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+#include "Point.h"
+#include "GridStorage.h"
+#include "OpenList.h"
+#include "SearchStats.h"
+
+// Anytime Repairing A* (Likhachev, Gordon, Thrun): the heuristic is first
+// inflated by a weight, which finds a path at most that factor longer than
+// optimal after few expansions. The weight is then lowered step by step down
+// to 1; each pass reuses the g values of the one before and only re-expands
+// cells whose g improved, so refining is much cheaper than a fresh search.
+// Every call works within a budget and can stop in the middle of a pass; the
+// next call with the same problem carries on from there.
+// 4-connected, honors terrain costs (CELL_TERRAIN).
+class ARAStar {
+public:
+    // Zero means no limit. Time is checked every few expansions, so a call
+    // can overrun maxMillis by a few microseconds.
+    struct Budget {
+        int maxExpansions = 0;
+        double maxMillis = 0.0;
+    };
+
+    explicit ARAStar(double initialWeight = 3.0, double weightStep = 0.5);
+
+    // Best path found so far after spending at most budget on improving it.
+    // A different start, goal or grid size (or a call after invalidate())
+    // starts over; ARA* cannot repair edited cells.
+    const std::pmr::vector<Point>& findPath(const GridView& grid, const Point& start, const Point& goal, const Budget& budget);
+
+    void invalidate() { initialized = false; }
+
+    // The last path costs at most bound() times the optimum; 1 once it is
+    // optimal, infinity while there is no path yet.
+    double bound() const { return pathBound; }
+    // Cost of the last path (terrain costs of the cells after the start).
+    int lastCost() const { return pathCost; }
+    // Weight of the pass in progress.
+    double weight() const { return currentWeight; }
+    // Nothing left to improve: the path is optimal, or there is none.
+    bool isFinished() const { return initialized && finished; }
+
+    // Work done by the last call. Cells re-expanded in a later pass count as reopenings.
+    const SearchStats& lastStats() const { return recorder.stats(); }
+    // Reports every expanded cell of the following calls; nullptr to stop.
+    void setTrace(SearchTrace callback, void* user = nullptr) { recorder.setTrace(callback, user); }
+
+private:
+    struct Key {
+        double f;  // g + weight * h
+        int h;
+
+        bool operator<(const Key& other) const {
+            return f < other.f || (f == other.f && h < other.h);
+        }
+    };
+
+    static constexpr int infinity = 0x3fffffff;
+
+    double initialWeight;
+    double weightStep;
+
+    bool initialized = false;
+    bool finished = false;
+    int rows = 0;
+    int cols = 0;
+    int stride = 0;
+    Point start;
+    Point goal;
+    int startIndex = 0;
+    int goalIndex = 0;
+    double currentWeight = 1.0;
+    double completedWeight = 0.0;  // weight of the last finished pass, 0 before the first
+    SearchRecorder recorder;
+
+    // Per padded cell. Cells stamped with an older generation read as
+    // unvisited, so starting a new query does not touch the whole grid.
+    struct Cell {
+        int g = infinity;
+        int parent = -1;
+        uint32_t generation = 0;
+        uint32_t closedPass = 0;   // pass the cell was last expanded in
+        bool inconsistent = false; // improved after its expansion in this pass
+    };
+
+    std::vector<Cell> cells;
+    uint32_t generation = 0;
+    uint32_t pass = 0;
+    std::vector<int> incons;
+    std::vector<int> scratch;
+    IndexedHeap<Key> openSet;
+
+    std::pmr::vector<Point> path;
+    int pathCost = infinity;
+    double pathBound = 0.0;
+
+    void initialize(const GridView& grid, const Point& start, const Point& goal);
+    Cell& cell(int index);
+    int g(int index) const;
+    int heuristic(int index) const;
+    Key key(int index) const;
+    bool improvePath(const GridView& grid, const Budget& budget, int& expansions, std::chrono::steady_clock::time_point begin);
+    void nextPass();
+    void extractPath(const GridView& grid);
+    double lowerBound() const;
+};
+
+#endif  // ARASTAR_H
@@ -1,118 +1,359 @@
-#include <Windows.h>
-#include <queue>
-#include <unordered_set>
+#include <climits>
+#include <cstdlib>
 #include <algorithm>
-#include "astar.h"
+#include "AStar.h"
 
-struct Node {
-    Point point;
-    int g;  // cost from start node to current node
-    int h;  // heuristic cost from current node to goal node
-    int f;  // total cost
+int AStar::calculateHeuristic(const Point& current, const Point& finish) const {
+    return abs(current.x - finish.x) + abs(current.y - finish.y);
+}
 
-    Node(Point point, int g, int h) : point(point), g(g), h(h), f(g + h) {}
-};
+int AStar::getNeighbors(const GridView& grid, int node, int (&neighbors)[4]) const {
+    // right, left, down, up; the wall border keeps every offset inside the buffer
+    const int offsets[4] = { 1, -1, grid.stride, -grid.stride };
 
-struct NodeCompare {
-    bool operator()(const Node& lhs, const Node& rhs) const {
-        return lhs.f > rhs.f;  // Min-heap based on f value
+    int count = 0;
+    for (int offset : offsets) {
+        if (!grid.isWall(node + offset)) {
+            neighbors[count++] = node + offset;
+        }
     }
-};
 
-bool AStar::isValid(const std::vector<std::vector<int>>& grid, int x, int y) {
-    int rows = grid.size();
-    int cols = grid[0].size();
-    // != 1: is not wall
-    return (x >= 0 && x < rows && y >= 0 && y < cols && grid[x][y] != 1);
+    return count;
 }
 
-int AStar::calculateHeuristic(const Point& current, const Point& finish) {
-    return abs(current.x - finish.x) + abs(current.y - finish.y);
-}
+void AStar::reconstructPath(const GridView& grid, const SearchState& state, int current, std::pmr::vector<Point>& path) const {
+    path.clear();
+    for (int curr = current; curr != SearchState::noParent; curr = state.parent(curr)) {
+        path.push_back(grid.point(curr));
+    }
 
-std::vector<Point> AStar::getNeighbors(const std::vector<std::vector<int>>& grid, const Point& node) {
-    std::vector<Point> neighbors;
-    int rows = grid.size();
-    int cols = grid[0].size();
+    std::reverse(path.begin(), path.end());
+}
 
-    std::vector<Point> offsets = { {0, 1}, {0, -1}, {1, 0}, {-1, 0} };  // right, left, down, up
+void AStar::reconstructJumpPath(const GridView& grid, const SearchState& state, int current, std::pmr::vector<Point>& path) const {
+    // jump points are joined by straight segments: fill in the skipped cells
+    path.clear();
+    for (int curr = current; curr != SearchState::noParent; curr = state.parent(curr)) {
+        path.push_back(grid.point(curr));
 
-    for (const Point& offset : offsets) {
-        int newX = node.x + offset.x;
-        int newY = node.y + offset.y;
+        int parent = state.parent(curr);
+        if (parent == SearchState::noParent) {
+            break;
+        }
 
-        if (isValid(grid, newX, newY)) {
-            neighbors.emplace_back(newX, newY);
+        int step = parent / grid.stride == curr / grid.stride ? 1 : grid.stride;
+        step = parent > curr ? step : -step;
+        for (int cell = curr + step; cell != parent; cell += step) {
+            path.push_back(grid.point(cell));
         }
     }
 
-    return neighbors;
+    std::reverse(path.begin(), path.end());
 }
 
-std::vector<Point> AStar::reconstructPath(const std::unordered_map<Point, Point>& cameFrom, const Point& current) {
-    std::vector<Point> path;
-    Point curr = current;
+std::vector<Point> AStar::findPath(const GridView& grid, const Point& start, const Point& finish, SearchMode mode) const {
+    SearchContext context;
+    const std::pmr::vector<Point>& path = findPath(context, grid, start, finish, mode);
+    return std::vector<Point>(path.begin(), path.end());
+}
 
-    while (cameFrom.find(curr) != cameFrom.end()) {
-        path.push_back(curr);
-        curr = cameFrom.at(curr);
+const std::pmr::vector<Point>& AStar::findPath(SearchContext& context, const GridView& grid, const Point& start, const Point& finish, SearchMode mode) const {
+    context.path.clear();
+    context.recorder.begin();
+    if (grid.empty() || !grid.contains(start) || !grid.contains(finish)) {
+        context.recorder.end();
+        return context.path;
     }
 
-    path.push_back(curr);
-    std::reverse(path.begin(), path.end());
+    context.openSet.resize(grid.cellCount());
+    context.state.reset(grid.cellCount());
 
-    return path;
+    switch (mode) {
+    case SearchMode::JumpPoint:
+        searchJumpPoint(context, grid, start, finish);
+        break;
+
+    case SearchMode::Bidirectional:
+        context.openSetBackward.resize(grid.cellCount());
+        context.stateBackward.reset(grid.cellCount());
+        searchBidirectional(context, grid, start, finish);
+        break;
+
+    case SearchMode::Weighted:
+        // f grows by at most the largest entry cost plus 1 per step
+        context.buckets.reset(CELL_MAX_COST + 1);
+        searchWeighted(context, grid, start, finish);
+        break;
+
+    case SearchMode::Landmark:
+        if (context.landmarks != nullptr && context.landmarks->fits(grid)) {
+            searchLandmark(context, grid, start, finish);
+        }
+        else {
+            searchStandard(context, grid, start, finish);
+        }
+        break;
+
+    default:
+        searchStandard(context, grid, start, finish);
+        break;
+    }
+
+    context.recorder.end();
+    return context.path;
+}
+
+void AStar::searchStandard(SearchContext& context, const GridView& grid, const Point& start, const Point& finish) const {
+    // the generic search compiles down to the same loop a hand-written 4-neighbor version would
+    BasicAStar<FourConnected, ManhattanDistance, int>::search(context.openSet, context.state, context.recorder, grid, start, finish, context.path);
 }
 
-std::vector<Point> AStar::findPath(const std::vector<std::vector<int>>& grid, const Point& start, const Point& finish) {
-    int rows = grid.size();
-    int cols = grid[0].size();
+int AStar::jump(const GridView& grid, int from, int step, int finish) const {
+    // cells beside the line of travel
+    int side = (step == 1 || step == -1) ? grid.stride : 1;
+
+    for (int cell = from + step; !grid.isWall(cell); cell += step) {
+        if (cell == finish) {
+            return cell;
+        }
+
+        // forced neighbor: a side cell that was blocked one step back opens up here
+        if ((!grid.isWall(cell + side) && grid.isWall(cell + side - step))
+            || (!grid.isWall(cell - side) && grid.isWall(cell - side - step))) {
+            return cell;
+        }
+
+        // moving along a row: stop wherever the crossing column holds a jump point
+        if (side == grid.stride && (jump(grid, cell, grid.stride, finish) != -1 || jump(grid, cell, -grid.stride, finish) != -1)) {
+            return cell;
+        }
+    }
+
+    return -1;
+}
 
-    std::priority_queue<Node, std::vector<Node>, NodeCompare> openSet;
-    std::unordered_set<Point> closedSet;
-    std::unordered_map<Point, Point> cameFrom;
+void AStar::searchJumpPoint(SearchContext& context, const GridView& grid, const Point& start, const Point& finish) const {
+    IndexedHeap<NodeKey>& openSet = context.openSet;
+    SearchState& state = context.state;
+    int finishIndex = grid.index(finish);
 
-    openSet.push(Node(start, 0, calculateHeuristic(start, finish)));
+    int startH = calculateHeuristic(start, finish);
+    state.open(grid.index(start), 0, SearchState::noParent);
+    openSet.push(grid.index(start), { startH, startH });
+    context.recorder.pushed(openSet.size());
 
+    int neighbors[4];
     while (!openSet.empty()) {
-        Node current = openSet.top();
-        openSet.pop();
+        int currentIndex = openSet.pop();
+        context.recorder.expanded(grid, currentIndex);
 
-        if (current.point.x == finish.x && current.point.y == finish.y) {
-            return reconstructPath(cameFrom, current.point);
+        if (currentIndex == finishIndex) {
+            reconstructJumpPath(grid, state, currentIndex, context.path);
+            return;
         }
 
-        closedSet.insert(current.point);
+        state.close(currentIndex);
+
+        // prune: never step back towards the parent, every other direction is a candidate
+        int parent = state.parent(currentIndex);
+        int back = 0;
+        if (parent != SearchState::noParent) {
+            back = parent / grid.stride == currentIndex / grid.stride ? 1 : grid.stride;
+            back = parent > currentIndex ? back : -back;
+        }
 
-        std::vector<Point> neighbors = getNeighbors(grid, current.point);
-        for (const Point& neighbor : neighbors) {
-            if (closedSet.find(neighbor) != closedSet.end()) {
+        int neighborCount = getNeighbors(grid, currentIndex, neighbors);
+        for (int i = 0; i < neighborCount; ++i) {
+            int step = neighbors[i] - currentIndex;
+            if (step == back) {
                 continue;
             }
 
-            int neighborG = current.g + 1;  // assuming each step has a cost of 1
-            int neighborH = calculateHeuristic(neighbor, finish);
-            int neighborF = neighborG + neighborH;
-
-            Node neighborNode(neighbor, neighborG, neighborH);
-
-            bool found = false;
-            std::priority_queue<Node, std::vector<Node>, NodeCompare> openSetCopy = openSet;
-            while (!openSetCopy.empty()) {
-                const Node& node = openSetCopy.top();
-                if ((node.point.x == neighbor.x && node.point.y == neighbor.y) && neighborF >= node.f) {
-                    found = true;
-                    break;
-                }
-                openSetCopy.pop();
+            int jumpIndex = jump(grid, currentIndex, step, finishIndex);
+            if (jumpIndex == -1 || state.status(jumpIndex) == SearchState::Closed) {
+                continue;
             }
 
-            if (!found) {
-                cameFrom[neighbor] = current.point;
-                openSet.push(neighborNode);
+            // jump points share a row or a column, so the distance is the step count
+            int distance = (jumpIndex - currentIndex) / step;
+            int jumpG = state.g(currentIndex) + distance;
+            if (jumpG >= state.g(jumpIndex)) {
+                continue;
             }
+
+            int jumpH = calculateHeuristic(grid.point(jumpIndex), finish);
+            state.open(jumpIndex, jumpG, currentIndex);
+            openSet.pushOrDecrease(jumpIndex, { jumpG + jumpH, jumpH });
+            context.recorder.pushed(openSet.size());
+        }
+    }
+
+    // no path found
+}
+
+void AStar::searchBidirectional(SearchContext& context, const GridView& grid, const Point& start, const Point& finish) const {
+    int startIndex = grid.index(start);
+    int finishIndex = grid.index(finish);
+
+    if (start == finish) {
+        context.path.push_back(start);
+        return;
+    }
+    if (grid.isWall(finishIndex)) {
+        return;  // the forward search could never enter the goal either
+    }
+
+    struct Side {
+        IndexedHeap<NodeKey>& openSet;
+        SearchState& state;
+        const SearchState& other;
+        Point target;
+    };
+    Side forward{ context.openSet, context.state, context.stateBackward, finish };
+    Side backward{ context.openSetBackward, context.stateBackward, context.state, start };
+
+    int startH = calculateHeuristic(start, finish);
+    forward.state.open(startIndex, 0, SearchState::noParent);
+    forward.openSet.push(startIndex, { startH, startH });
+    backward.state.open(finishIndex, 0, SearchState::noParent);
+    backward.openSet.push(finishIndex, { startH, startH });
+    context.recorder.pushed(forward.openSet.size());
+    context.recorder.pushed(forward.openSet.size() + backward.openSet.size());
+
+    int best = INT_MAX;  // cheapest start-goal path seen through a cell both sides reached
+    int meeting = -1;
+    const int offsets[4] = { 1, -1, grid.stride, -grid.stride };
+
+    while (!forward.openSet.empty() && !backward.openSet.empty()) {
+        // both f values bound every path not seen yet from below
+        if (best <= std::max(forward.openSet.topKey().f, backward.openSet.topKey().f)) {
+            break;
+        }
+
+        // grow the smaller frontier: a walled-off start or goal is exhausted quickly
+        Side& side = forward.openSet.size() <= backward.openSet.size() ? forward : backward;
+
+        int currentIndex = side.openSet.pop();
+        context.recorder.expanded(grid, currentIndex);
+        side.state.close(currentIndex);
+
+        for (int offset : offsets) {
+            int neighborIndex = currentIndex + offset;
+            // walking backwards the start may be entered even if it is painted over
+            if (grid.isWall(neighborIndex) && !(&side == &backward && neighborIndex == startIndex)) {
+                continue;
+            }
+
+            if (side.state.status(neighborIndex) == SearchState::Closed) {
+                continue;
+            }
+
+            int neighborG = side.state.g(currentIndex) + 1;
+            if (neighborG >= side.state.g(neighborIndex)) {
+                continue;
+            }
+
+            int neighborH = calculateHeuristic(grid.point(neighborIndex), side.target);
+            side.state.open(neighborIndex, neighborG, currentIndex);
+            side.openSet.pushOrDecrease(neighborIndex, { neighborG + neighborH, neighborH });
+            context.recorder.pushed(forward.openSet.size() + backward.openSet.size());
+
+            int otherG = side.other.g(neighborIndex);
+            if (otherG != INT_MAX && neighborG + otherG < best) {
+                best = neighborG + otherG;
+                meeting = neighborIndex;
+            }
+        }
+    }
+
+    // an exhausted side has settled every cell it can reach, so best is final
+    if (meeting == -1) {
+        return;  // no path found
+    }
+
+    reconstructPath(grid, forward.state, meeting, context.path);
+    for (int curr = backward.state.parent(meeting); curr != SearchState::noParent; curr = backward.state.parent(curr)) {
+        context.path.push_back(grid.point(curr));
+    }
+}
+
+void AStar::searchWeighted(SearchContext& context, const GridView& grid, const Point& start, const Point& finish) const {
+    searchBuckets(context, grid, context.state, context.buckets, start, finish, true);
+}
+
+void AStar::searchLandmark(SearchContext& context, const GridView& grid, const Point& start, const Point& finish) const {
+    // Standard's loop with max(Manhattan, ALT) in place of Manhattan
+    BasicAStar<FourConnected, LandmarkHeuristic, int>::search(context.openSet, context.state, context.recorder, grid, start, finish, context.path,
+        LandmarkHeuristic(*context.landmarks));
+}
+
+const std::pmr::vector<Point>& AStar::findPath(SearchContext& context, const TiledGridView& grid, const Point& start, const Point& finish, SearchMode mode) const {
+    context.path.clear();
+    context.recorder.begin();
+    if (grid.empty() || !grid.contains(start) || !grid.contains(finish)) {
+        context.recorder.end();
+        return context.path;
+    }
+
+    // a step raises f by its cost plus at most 1 for the heuristic
+    bool weighted = mode == SearchMode::Weighted;
+    context.sparseBuckets.reset(weighted ? CELL_MAX_COST + 1 : 2);
+    context.sparseState.reset();
+    searchBuckets(context, grid, context.sparseState, context.sparseBuckets, start, finish, weighted);
+    context.recorder.end();
+    return context.path;
+}
+
+template <typename View, typename State, typename Queue>
+void AStar::searchBuckets(SearchContext& context, const View& grid, State& state, Queue& openSet, const Point& start, const Point& finish, bool weighted) const {
+    using Index = decltype(grid.index(start));
+    Index finishIndex = grid.index(finish);
+    const int offsets[4] = { 1, -1, grid.stride, -grid.stride };
+
+    // every step costs at least 1, so Manhattan stays a consistent lower bound
+    int startH = calculateHeuristic(start, finish);
+    state.open(grid.index(start), 0, State::noParent);
+    openSet.push(grid.index(start), 0, startH);
+    context.recorder.pushed(openSet.size());
+
+    while (!openSet.empty()) {
+        typename Queue::Entry entry = openSet.pop();
+        Index currentIndex = entry.id;
+
+        // improved cells are pushed again instead of moved; skip what is left behind
+        if (state.status(currentIndex) == SearchState::Closed || entry.g != state.g(currentIndex)) {
+            context.recorder.stalePop();
+            continue;
+        }
+        context.recorder.expanded(grid, currentIndex);
+
+        if (currentIndex == finishIndex) {
+            for (Index curr = currentIndex; curr != State::noParent; curr = state.parent(curr)) {
+                context.path.push_back(grid.point(curr));
+            }
+            std::reverse(context.path.begin(), context.path.end());
+            return;
+        }
+
+        state.close(currentIndex);
+
+        for (int offset : offsets) {
+            Index neighborIndex = currentIndex + offset;
+            if (grid.isWall(neighborIndex) || state.status(neighborIndex) == SearchState::Closed) {
+                continue;
+            }
+
+            int neighborG = entry.g + (weighted ? grid.cost(neighborIndex) : 1);
+            if (neighborG >= state.g(neighborIndex)) {
+                continue;
+            }
+
+            int neighborH = calculateHeuristic(grid.point(neighborIndex), finish);
+            state.open(neighborIndex, neighborG, currentIndex);
+            openSet.push(neighborIndex, neighborG, neighborG + neighborH);
+            context.recorder.pushed(openSet.size());
         }
     }
 
-    return {};  // no path found
+    // no path found
 }
@@ -2,40 +2,90 @@
 #define ASTAR_H
 
 #include <vector>
-#include <unordered_map>
-#include <functional>
+#include <memory_resource>
+#include "Point.h"
+#include "GridStorage.h"
+#include "OpenList.h"
+#include "SearchState.h"
+#include "SearchStats.h"
+#include "BucketQueue.h"
+#include "BasicAStar.h"
+#include "Landmarks.h"
+#include "TiledGrid.h"
 
-struct Point {
-    int x;
-    int y;
+using NodeKey = BasicNodeKey<int>;
 
-    Point(int x = 0, int y = 0) : x(x), y(y) {}
-
-    bool operator==(const Point& other) const {
-        return x == other.x && y == other.y;
-    }
+enum class SearchMode {
+    Standard,       // plain A* over every cell
+    JumpPoint,      // jump point search: same path length, far fewer open-list operations on open maps
+    Bidirectional,  // A* from both ends; stops early when either end is sealed off
+    Weighted,       // honors terrain costs (CELL_TERRAIN) with a bucket open list; the other modes treat every passable cell as cost 1
+    Landmark,       // Standard guided by the ALT heuristic of the context's landmarks (setLandmarks); far fewer expansions in mazes and rooms
 };
 
-namespace std {
-    template <>
-    struct hash<Point> {
-        size_t operator()(const Point& p) const {
-            size_t h1 = std::hash<int>{}(p.x);
-            size_t h2 = std::hash<int>{}(p.y);
-            return h1 ^ (h2 << 1);
-        }
-    };
-}
-
 class AStar {
 public:
-    std::vector<Point> findPath(const std::vector<std::vector<int>>& grid, const Point& start, const Point& goal);
+    // Scratch memory of a search: open list, per-cell state and the output
+    // path. Reusing one context across queries on the same grid size makes
+    // steady-state queries allocation free; pass an arena or pool resource to
+    // control where the buffers live.
+    class SearchContext {
+    public:
+        explicit SearchContext(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : openSet(0, resource), state(resource), openSetBackward(0, resource), stateBackward(resource), buckets(resource),
+              sparseBuckets(resource), sparseState(resource), path(resource) {}
+
+        const std::pmr::vector<Point>& lastPath() const { return path; }
+        const SearchStats& lastStats() const { return recorder.stats(); }
+        // Reports every expanded cell of the following queries; nullptr to stop.
+        void setTrace(SearchTrace callback, void* user = nullptr) { recorder.setTrace(callback, user); }
+        // Landmark tables for SearchMode::Landmark, built for the grids searched
+        // and kept up to date by the caller; without them that mode is Standard.
+        void setLandmarks(const Landmarks* tables) { landmarks = tables; }
+
+    private:
+        friend class AStar;
+
+        IndexedHeap<NodeKey> openSet;
+        SearchState state;
+        IndexedHeap<NodeKey> openSetBackward;  // only touched by bidirectional searches
+        SearchState stateBackward;
+        BucketQueue buckets;  // only touched by weighted searches
+        BasicBucketQueue<SparseSearchState::Index> sparseBuckets;  // only touched by paged searches
+        SparseSearchState sparseState;
+        std::pmr::vector<Point> path;
+        SearchRecorder recorder;
+        const Landmarks* landmarks = nullptr;
+    };
+
+    // AStar itself holds no state: concurrent calls are safe as long as every
+    // thread uses its own SearchContext.
+    std::vector<Point> findPath(const GridView& grid, const Point& start, const Point& goal, SearchMode mode = SearchMode::Standard) const;
+    // Result stays valid until the next query on the same context.
+    const std::pmr::vector<Point>& findPath(SearchContext& context, const GridView& grid, const Point& start, const Point& goal, SearchMode mode = SearchMode::Standard) const;
+
+    // Searches a paged grid through the same view interface, keeping the
+    // per-cell state only for the cells it touches. Weighted honors terrain
+    // costs, every other mode searches like Standard. Same paths as on the
+    // grid in memory, slower by the tile lookups.
+    const std::pmr::vector<Point>& findPath(SearchContext& context, const TiledGridView& grid, const Point& start, const Point& goal, SearchMode mode = SearchMode::Standard) const;
 
 private:
-    bool isValid(const std::vector<std::vector<int>>& grid, int x, int y);
-    int calculateHeuristic(const Point& current, const Point& goal);
-    std::vector<Point> getNeighbors(const std::vector<std::vector<int>>& grid, const Point& node);
-    std::vector<Point> reconstructPath(const std::unordered_map<Point, Point>& cameFrom, const Point& current);
+    int calculateHeuristic(const Point& current, const Point& goal) const;
+    int getNeighbors(const GridView& grid, int node, int (&neighbors)[4]) const;
+    void reconstructPath(const GridView& grid, const SearchState& state, int current, std::pmr::vector<Point>& path) const;
+    void reconstructJumpPath(const GridView& grid, const SearchState& state, int current, std::pmr::vector<Point>& path) const;
+
+    void searchStandard(SearchContext& context, const GridView& grid, const Point& start, const Point& goal) const;
+    void searchJumpPoint(SearchContext& context, const GridView& grid, const Point& start, const Point& goal) const;
+    void searchBidirectional(SearchContext& context, const GridView& grid, const Point& start, const Point& goal) const;
+    void searchWeighted(SearchContext& context, const GridView& grid, const Point& start, const Point& goal) const;
+    void searchLandmark(SearchContext& context, const GridView& grid, const Point& start, const Point& goal) const;
+    // Dial's bucket queue over dense or sparse per-cell state: Weighted in
+    // memory and every mode on a paged grid, where unweighted steps cost 1.
+    template <typename View, typename State, typename Queue>
+    void searchBuckets(SearchContext& context, const View& grid, State& state, Queue& openSet, const Point& start, const Point& goal, bool weighted) const;
+    int jump(const GridView& grid, int from, int step, int goal) const;
 };
 
 #endif  // ASTAR_H
@@ -0,0 +1,241 @@
+#ifndef BASICASTAR_H
+#define BASICASTAR_H
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <type_traits>
+#include <memory_resource>
+#include "Point.h"
+#include "GridStorage.h"
+#include "OpenList.h"
+#include "SearchState.h"
+#include "SearchStats.h"
+#include "Landmarks.h"
+
+// Heap key: lowest f first, ties go to the node closer to the goal.
+template <typename CostT>
+struct BasicNodeKey {
+    CostT f;
+    CostT h;
+
+    bool operator<(const BasicNodeKey& other) const {
+        return f < other.f || (f == other.f && h < other.h);
+    }
+};
+
+// Connectivity policies: constexpr step tables plus the cost of a straight and
+// a diagonal step. Steps are listed in the order they are tried.
+struct FourConnected {
+    static constexpr int count = 4;
+    static constexpr int rowStep[count] = { 0, 0, 1, -1 };  // right, left, down, up
+    static constexpr int colStep[count] = { 1, -1, 0, 0 };
+
+    template <typename CostT> static constexpr CostT straightCost = 1;
+    // a diagonal displacement takes two straight steps
+    template <typename CostT> static constexpr CostT diagonalCost = 2;
+};
+
+struct EightConnected {
+    static constexpr int count = 8;
+    static constexpr int rowStep[count] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+    static constexpr int colStep[count] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+
+    // Integer costs use 70/99: the ratio is just above sqrt(2), so straight
+    // line distances stay lower bounds and no floating point is needed.
+    template <typename CostT> static constexpr CostT straightCost = std::is_integral_v<CostT> ? CostT(70) : CostT(1);
+    template <typename CostT> static constexpr CostT diagonalCost = std::is_integral_v<CostT> ? CostT(99) : CostT(1.4142135623730951);
+};
+
+// Terrain policies: the factor entering a cell multiplies the step cost by.
+// Every factor is at least 1, so the heuristics below stay admissible.
+struct UniformTerrain {
+    static int factor(const GridView&, int) { return 1; }
+};
+
+// Per-cell costs stored in the grid, see CELL_TERRAIN.
+struct WeightedTerrain {
+    static int factor(const GridView& grid, int index) { return grid.cost(index); }
+};
+
+// Heuristics, in the step costs of the connectivity they are used with.
+// BasicAStar holds one by instance and asks it for the distance between two
+// cells as both the row and column gap and the GridView indices; distance
+// heuristics only need the former, stateful ones may look the cells up.
+
+// Exact on open 4-connected grids; overestimates diagonal moves, so with
+// 8-connectivity it trades optimality for fewer expansions.
+struct ManhattanDistance {
+    template <typename Connectivity, typename CostT>
+    static CostT estimate(int dRow, int dCol, int = 0, int = 0) {
+        return Connectivity::template straightCost<CostT> * CostT(dRow + dCol);
+    }
+};
+
+// Exact on open 8-connected grids, Manhattan on 4-connected ones.
+struct OctileDistance {
+    template <typename Connectivity, typename CostT>
+    static CostT estimate(int dRow, int dCol, int = 0, int = 0) {
+        CostT straight = Connectivity::template straightCost<CostT>;
+        CostT diagonal = Connectivity::template diagonalCost<CostT>;
+        return straight * CostT(std::max(dRow, dCol)) + (diagonal - straight) * CostT(std::min(dRow, dCol));
+    }
+};
+
+// Straight-line distance: admissible for every connectivity, but the weakest bound.
+struct EuclideanDistance {
+    template <typename Connectivity, typename CostT>
+    static CostT estimate(int dRow, int dCol, int = 0, int = 0) {
+        double distance = std::sqrt(static_cast<double>(dRow) * dRow + static_cast<double>(dCol) * dCol);
+        return static_cast<CostT>(Connectivity::template straightCost<CostT> * distance);  // truncation keeps it a lower bound
+    }
+};
+
+// ALT: the larger of Manhattan and the landmark bound. Both are consistent,
+// so their maximum is too and closed cells stay closed. The tables count
+// 4-connected steps and must have been built for the grid searched.
+class LandmarkHeuristic {
+public:
+    explicit LandmarkHeuristic(const Landmarks& tables) : landmarks(&tables) {}
+
+    template <typename Connectivity, typename CostT>
+    CostT estimate(int dRow, int dCol, int from, int to) const {
+        static_assert(std::is_same_v<Connectivity, FourConnected>, "landmark distances are 4-connected steps");
+        return std::max(ManhattanDistance::estimate<Connectivity, CostT>(dRow, dCol), CostT(landmarks->estimate(from, to)));
+    }
+
+private:
+    const Landmarks* landmarks;
+};
+
+// A* with the neighbor table, heuristic, cost type and terrain model fixed at
+// compile time, so each configuration gets its own fully inlined inner loop.
+// Diagonal steps never cut a corner: both cells beside the move must be free.
+template <typename Connectivity, typename Heuristic, typename CostT = int, typename Terrain = UniformTerrain>
+class BasicAStar {
+public:
+    using Key = BasicNodeKey<CostT>;
+    using State = BasicSearchState<CostT>;
+
+    explicit BasicAStar(const Heuristic& heuristic = Heuristic()) : heuristic(heuristic) {}
+
+    // Reusable scratch memory, see AStar::SearchContext.
+    class SearchContext {
+    public:
+        explicit SearchContext(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : openSet(0, resource), state(resource), path(resource) {}
+
+        const std::pmr::vector<Point>& lastPath() const { return path; }
+        // Cost of the last path in Connectivity's step costs, State::unreached if none.
+        CostT lastCost() const { return cost; }
+        const SearchStats& lastStats() const { return recorder.stats(); }
+        void setTrace(SearchTrace callback, void* user = nullptr) { recorder.setTrace(callback, user); }
+
+    private:
+        friend class BasicAStar;
+
+        IndexedHeap<Key> openSet;
+        State state;
+        std::pmr::vector<Point> path;
+        CostT cost = State::unreached;
+        SearchRecorder recorder;
+    };
+
+    std::vector<Point> findPath(const GridView& grid, const Point& start, const Point& goal) const {
+        SearchContext context;
+        const std::pmr::vector<Point>& path = findPath(context, grid, start, goal);
+        return std::vector<Point>(path.begin(), path.end());
+    }
+
+    // Result stays valid until the next query on the same context.
+    const std::pmr::vector<Point>& findPath(SearchContext& context, const GridView& grid, const Point& start, const Point& goal) const {
+        context.path.clear();
+        context.cost = State::unreached;
+        context.recorder.begin();
+        if (!grid.empty() && grid.contains(start) && grid.contains(goal)) {
+            context.openSet.resize(grid.cellCount());
+            context.state.reset(grid.cellCount());
+            context.cost = search(context.openSet, context.state, context.recorder, grid, start, goal, context.path, heuristic);
+        }
+        context.recorder.end();
+        return context.path;
+    }
+
+    // The search itself, on caller-owned buffers that are already sized and
+    // reset for grid. Returns the path cost, State::unreached if there is none.
+    static CostT search(IndexedHeap<Key>& openSet, State& state, SearchRecorder& recorder, const GridView& grid, const Point& start, const Point& goal,
+        std::pmr::vector<Point>& path, const Heuristic& heuristic = Heuristic()) {
+        // the wall border keeps every offset, diagonals included, inside the buffer
+        int offsets[Connectivity::count];
+        for (int i = 0; i < Connectivity::count; ++i) {
+            offsets[i] = Connectivity::rowStep[i] * grid.stride + Connectivity::colStep[i];
+        }
+
+        int startIndex = grid.index(start);
+        int goalIndex = grid.index(goal);
+
+        CostT startH = estimate(heuristic, start, startIndex, goal, goalIndex);
+        state.open(startIndex, CostT(0), State::noParent);
+        openSet.push(startIndex, { startH, startH });
+        recorder.pushed(openSet.size());
+
+        while (!openSet.empty()) {
+            int currentIndex = openSet.pop();
+            recorder.expanded(grid, currentIndex);
+
+            if (currentIndex == goalIndex) {
+                reconstructPath(grid, state, currentIndex, path);
+                return state.g(currentIndex);
+            }
+
+            state.close(currentIndex);
+            CostT currentG = state.g(currentIndex);
+
+            for (int i = 0; i < Connectivity::count; ++i) {
+                int neighborIndex = currentIndex + offsets[i];
+                if (grid.isWall(neighborIndex) || state.status(neighborIndex) == State::Closed) {
+                    continue;
+                }
+
+                bool diagonal = Connectivity::rowStep[i] != 0 && Connectivity::colStep[i] != 0;
+                if (diagonal
+                    && (grid.isWall(currentIndex + Connectivity::rowStep[i] * grid.stride)
+                        || grid.isWall(currentIndex + Connectivity::colStep[i]))) {
+                    continue;
+                }
+
+                CostT step = diagonal ? Connectivity::template diagonalCost<CostT> : Connectivity::template straightCost<CostT>;
+                CostT neighborG = currentG + step * CostT(Terrain::factor(grid, neighborIndex));
+                if (!(neighborG < state.g(neighborIndex))) {
+                    continue;
+                }
+
+                CostT neighborH = estimate(heuristic, grid.point(neighborIndex), neighborIndex, goal, goalIndex);
+                state.open(neighborIndex, neighborG, currentIndex);
+                openSet.pushOrDecrease(neighborIndex, { neighborG + neighborH, neighborH });
+                recorder.pushed(openSet.size());
+            }
+        }
+
+        return State::unreached;  // no path found
+    }
+
+private:
+    Heuristic heuristic;
+
+    static CostT estimate(const Heuristic& heuristic, const Point& from, int fromIndex, const Point& to, int toIndex) {
+        return heuristic.template estimate<Connectivity, CostT>(std::abs(from.x - to.x), std::abs(from.y - to.y), fromIndex, toIndex);
+    }
+
+    static void reconstructPath(const GridView& grid, const State& state, int current, std::pmr::vector<Point>& path) {
+        path.clear();
+        for (int curr = current; curr != State::noParent; curr = state.parent(curr)) {
+            path.push_back(grid.point(curr));
+        }
+
+        std::reverse(path.begin(), path.end());
+    }
+};
+
+#endif  // BASICASTAR_H
@@ -0,0 +1,18 @@
+#include "BatchPathFinder.h"
+
+BatchPathFinder::BatchPathFinder(unsigned threadCount) : pool(threadCount) {
+    for (unsigned i = 0; i < pool.threadCount(); ++i) {
+        contexts.push_back(std::make_unique<AStar::SearchContext>());
+    }
+}
+
+std::vector<std::vector<Point>> BatchPathFinder::findPaths(const GridView& grid, const std::vector<PathQuery>& queries) {
+    std::vector<std::vector<Point>> results(queries.size());
+
+    pool.run(queries.size(), [&](size_t item, unsigned worker) {
+        const PathQuery& query = queries[item];
+        const std::pmr::vector<Point>& path = path_finder.findPath(*contexts[worker], grid, query.start, query.goal, query.mode);
+        results[item].assign(path.begin(), path.end());
+    });
+    return results;
+}
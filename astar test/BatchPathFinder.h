@@ -0,0 +1,43 @@
+#ifndef BATCHPATHFINDER_H
+#define BATCHPATHFINDER_H
+
+#include <vector>
+#include <memory>
+#include "AStar.h"
+#include "WorkerPool.h"
+
+struct PathQuery {
+    Point start;
+    Point goal;
+    SearchMode mode = SearchMode::Standard;
+};
+
+// Answers many start/goal queries against one read-only grid on a WorkerPool.
+// Every worker owns a SearchContext; queries are handed out one at a time, so
+// a few long queries do not leave the other cores idle.
+class BatchPathFinder {
+public:
+    // threadCount includes the calling thread; 0 picks one per hardware thread.
+    explicit BatchPathFinder(unsigned threadCount = 0);
+
+    // Blocks until every query is answered; results[i] belongs to queries[i].
+    // Not reentrant: one batch at a time per BatchPathFinder.
+    std::vector<std::vector<Point>> findPaths(const GridView& grid, const std::vector<PathQuery>& queries);
+
+    unsigned threadCount() const { return pool.threadCount(); }
+
+    // Landmarks for SearchMode::Landmark queries, shared read-only by every
+    // worker; set between batches.
+    void setLandmarks(const Landmarks* tables) {
+        for (const std::unique_ptr<AStar::SearchContext>& context : contexts) {
+            context->setLandmarks(tables);
+        }
+    }
+
+private:
+    AStar path_finder;
+    WorkerPool pool;
+    std::vector<std::unique_ptr<AStar::SearchContext>> contexts;  // one per worker of the pool
+};
+
+#endif  // BATCHPATHFINDER_H
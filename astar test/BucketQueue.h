@@ -0,0 +1,84 @@
+#ifndef BUCKETQUEUE_H
+#define BUCKETQUEUE_H
+
+#include <vector>
+#include <cstddef>
+#include <memory_resource>
+
+// Dial's monotone bucket queue for small integer keys: a ring of maxStep + 1
+// buckets, O(1) push and amortized O(1) pop, no comparisons at all.
+// Keys must never drop below the last popped key and may exceed it by at most
+// maxStep, which holds for A* with a consistent heuristic and bounded step costs.
+// There is no decrease-key: push the id again and skip the outdated entry when
+// it is popped (the caller knows the current g of every id).
+// Id is the type of the cell indices: int, or 64-bit for paged grids.
+template <typename Id>
+class BasicBucketQueue {
+public:
+    struct Entry {
+        Id id;
+        int g;  // g at push time, to recognize outdated entries
+    };
+
+    explicit BasicBucketQueue(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : buckets(resource) {}
+
+    // Empties the queue for keys that grow by at most maxStep per push; bucket
+    // memory is kept for the next search.
+    void reset(int maxStep) {
+        size_t count = static_cast<size_t>(maxStep) + 1;
+        if (buckets.size() != count) {
+            buckets.resize(count);
+        }
+        for (auto& bucket : buckets) {
+            bucket.clear();
+        }
+        entries = 0;
+        cursor = 0;
+        cursorKey = 0;
+        started = false;
+    }
+
+    size_t size() const { return entries; }
+    bool empty() const { return entries == 0; }
+
+    void push(Id id, int g, int key) {
+        if (!started) {
+            cursorKey = key;  // the ring starts wherever the first key lands
+            started = true;
+        }
+        size_t bucket = (cursor + static_cast<size_t>(key - cursorKey)) % buckets.size();
+        buckets[bucket].push_back({ id, g });
+        ++entries;
+    }
+
+    // Key of the next pop; moves the cursor to the first non-empty bucket.
+    int topKey() {
+        while (buckets[cursor].empty()) {
+            cursor = cursor + 1 == buckets.size() ? 0 : cursor + 1;
+            ++cursorKey;
+        }
+        return cursorKey;
+    }
+
+    // Newest entry of the lowest bucket: within one f the search goes deep,
+    // which favors cells close to the goal like the heap's h tie-break does.
+    Entry pop() {
+        topKey();
+        Entry entry = buckets[cursor].back();
+        buckets[cursor].pop_back();
+        --entries;
+        return entry;
+    }
+
+private:
+    std::pmr::vector<std::pmr::vector<Entry>> buckets;
+    size_t entries = 0;
+    size_t cursor = 0;  // bucket holding cursorKey
+    int cursorKey = 0;  // only ever grows: later keys may not go below it
+    bool started = false;
+};
+
+using BucketQueue = BasicBucketQueue<int>;
+
+#endif  // BUCKETQUEUE_H
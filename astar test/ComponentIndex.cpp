@@ -0,0 +1,213 @@
+#include <utility>
+#include "ComponentIndex.h"
+
+int ComponentIndex::find(int l) {
+    while (parent[l] != l) {
+        parent[l] = parent[parent[l]];  // path halving
+        l = parent[l];
+    }
+    return l;
+}
+
+void ComponentIndex::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) {
+        return;
+    }
+
+    if (rank[a] < rank[b]) {
+        std::swap(a, b);
+    }
+    parent[b] = a;
+    if (rank[a] == rank[b]) {
+        ++rank[a];
+    }
+    --components;
+}
+
+int ComponentIndex::newLabel() {
+    int l = static_cast<int>(parent.size());
+    parent.push_back(l);
+    rank.push_back(0);
+    ++components;
+    return l;
+}
+
+void ComponentIndex::flood(const GridView& grid, int from, int newLabel) {
+    floodQueue.clear();
+    floodQueue.push_back(from);
+    label[from] = newLabel;
+
+    for (size_t head = 0; head < floodQueue.size(); ++head) {
+        int current = floodQueue[head];
+        for (int offset : { 1, -1, grid.stride, -grid.stride }) {
+            int neighbor = current + offset;
+            if (!grid.isWall(neighbor) && label[neighbor] != newLabel) {
+                label[neighbor] = newLabel;
+                floodQueue.push_back(neighbor);
+            }
+        }
+    }
+
+    relabeled += static_cast<long long>(floodQueue.size());
+}
+
+void ComponentIndex::build(const GridView& grid) {
+    label.assign(grid.cellCount(), noLabel);
+    parent.clear();
+    rank.clear();
+    components = 0;
+
+    for (int row = 0; row < grid.rows; ++row) {
+        for (int col = 0; col < grid.cols; ++col) {
+            int cell = grid.index(Point(row, col));
+            if (!grid.isWall(cell) && label[cell] == noLabel) {
+                flood(grid, cell, newLabel());
+            }
+        }
+    }
+
+    relabeled = 0;
+    visitStamp.assign(grid.cellCount(), 0);
+    visitOwner.assign(grid.cellCount(), 0);
+    stamp = 0;
+}
+
+void ComponentIndex::cellOpened(const GridView& grid, int row, int col) {
+    int cell = grid.index(Point(row, col));
+    if (label[cell] != noLabel) {
+        return;
+    }
+
+    // splits leave dead labels behind; start over once they outnumber the cells
+    if (parent.size() > label.size()) {
+        build(grid);
+        return;
+    }
+
+    for (int offset : { 1, -1, grid.stride, -grid.stride }) {
+        int neighbor = label[cell + offset];
+        if (neighbor == noLabel) {
+            continue;
+        }
+        if (label[cell] == noLabel) {
+            label[cell] = neighbor;
+        }
+        else {
+            unite(label[cell], neighbor);
+        }
+    }
+
+    if (label[cell] == noLabel) {
+        label[cell] = newLabel();  // an island of its own
+    }
+}
+
+int ComponentIndex::owner(int search) const {
+    while (searches[search].mergedInto != search) {
+        search = searches[search].mergedInto;
+    }
+    return search;
+}
+
+void ComponentIndex::cellBlocked(const GridView& grid, int row, int col) {
+    int cell = grid.index(Point(row, col));
+    if (label[cell] == noLabel) {
+        return;
+    }
+    label[cell] = noLabel;
+
+    if (parent.size() > label.size()) {
+        build(grid);
+        return;
+    }
+
+    if (++stamp == 0) {
+        visitStamp.assign(visitStamp.size(), 0);
+        stamp = 1;
+    }
+
+    // one search per free neighbor; they were all connected through cell
+    int count = 0;
+    for (int offset : { 1, -1, grid.stride, -grid.stride }) {
+        int neighbor = cell + offset;
+        if (label[neighbor] == noLabel) {
+            continue;
+        }
+
+        Search& search = searches[count];
+        search.origin = neighbor;
+        search.mergedInto = count;
+        search.done = false;
+        search.head = 0;
+        search.queue.clear();
+        search.queue.push_back(neighbor);
+        visitStamp[neighbor] = stamp;
+        visitOwner[neighbor] = static_cast<uint8_t>(count);
+        ++count;
+    }
+
+    if (count == 0) {
+        --components;  // the cell was a component on its own
+        return;
+    }
+
+    // Expand every open group by one cell per round. Groups that meet are
+    // merged; a group that runs dry has been cut off and gets a fresh label.
+    // The last group standing keeps the old one.
+    int running = count;
+    while (running > 1) {
+        for (int i = 0; i < count && running > 1; ++i) {
+            Search& search = searches[i];
+            if (search.done || search.mergedInto != i) {
+                continue;
+            }
+
+            if (search.head == search.queue.size()) {
+                search.done = true;
+                --running;
+                flood(grid, search.origin, newLabel());
+                continue;
+            }
+
+            int current = search.queue[search.head++];
+            for (int offset : { 1, -1, grid.stride, -grid.stride }) {
+                int neighbor = current + offset;
+                if (grid.isWall(neighbor)) {
+                    continue;
+                }
+
+                if (visitStamp[neighbor] != stamp) {
+                    visitStamp[neighbor] = stamp;
+                    visitOwner[neighbor] = static_cast<uint8_t>(i);
+                    search.queue.push_back(neighbor);
+                    continue;
+                }
+
+                int other = owner(visitOwner[neighbor]);
+                if (other != i) {
+                    // same piece after all: carry on with the other group's frontier too
+                    Search& merged = searches[other];
+                    search.queue.insert(search.queue.end(), merged.queue.begin() + merged.head, merged.queue.end());
+                    merged.mergedInto = i;
+                    --running;
+                }
+            }
+        }
+    }
+}
+
+bool ComponentIndex::connected(const GridView& grid, const Point& a, const Point& b) {
+    if (!grid.contains(a) || !grid.contains(b)) {
+        return false;
+    }
+
+    int la = label[grid.index(a)];
+    int lb = label[grid.index(b)];
+    if (la == noLabel || lb == noLabel) {
+        return false;
+    }
+
+    return find(la) == find(lb);
+}
@@ -0,0 +1,64 @@
+#ifndef COMPONENTINDEX_H
+#define COMPONENTINDEX_H
+
+#include <vector>
+#include <cstdint>
+#include "Point.h"
+#include "GridStorage.h"
+
+// Connected components of the passable cells (4-connected, like the searches),
+// so a query whose start and goal are apart fails in O(1) instead of flooding
+// everything reachable first.
+// Every cell holds a component label; labels are merged in a small union-find
+// when a wall opens. A new wall can split a component: the cells beside it race
+// each other in lockstep BFS, and only pieces that get sealed off are relabeled,
+// so the cost is bounded by the smaller side rather than the whole map.
+class ComponentIndex {
+public:
+    // Full labeling; call once, then report every wall change.
+    void build(const GridView& grid);
+    bool isBuilt() const { return !label.empty(); }
+
+    // Both take the grid after the change: the cell was a wall and is passable
+    // now, or the other way round.
+    void cellOpened(const GridView& grid, int row, int col);
+    void cellBlocked(const GridView& grid, int row, int col);
+
+    // False if either cell is a wall or they lie in different components.
+    bool connected(const GridView& grid, const Point& a, const Point& b);
+
+    int componentCount() const { return components; }
+    // Cells rewritten by splits since build(), to judge what edits cost.
+    long long relabeledCells() const { return relabeled; }
+
+private:
+    static constexpr int noLabel = -1;
+
+    std::vector<int> label;   // per padded cell, noLabel for walls
+    std::vector<int> parent;  // union-find over labels
+    std::vector<int> rank;
+    int components = 0;
+    long long relabeled = 0;
+
+    // lockstep BFS scratch, kept between edits
+    struct Search {
+        int origin;
+        int mergedInto;  // itself while still running on its own
+        bool done;
+        size_t head;
+        std::vector<int> queue;
+    };
+    Search searches[4];
+    std::vector<uint32_t> visitStamp;
+    std::vector<uint8_t> visitOwner;
+    uint32_t stamp = 0;
+    std::vector<int> floodQueue;
+
+    int find(int l);
+    void unite(int a, int b);
+    int newLabel();
+    void flood(const GridView& grid, int from, int newLabel);
+    int owner(int search) const;
+};
+
+#endif  // COMPONENTINDEX_H
@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <unordered_set>
+#include "CooperativePlanner.h"
+
+void CooperativePlanner::GoalDistance::reset(const GridView& grid, int goal, int newTarget) {
+    stride = grid.stride;
+    target = newTarget;
+    table.assign(64, Slot{ -1, 0 });
+    used = 0;
+    open = decltype(open)();
+    slot(goal).g = 0;
+    open.push({ heuristic(goal), goal });
+}
+
+int CooperativePlanner::GoalDistance::heuristic(int cell) const {
+    return abs(cell / stride - target / stride) + abs(cell % stride - target % stride);
+}
+
+const CooperativePlanner::GoalDistance::Slot* CooperativePlanner::GoalDistance::find(int cell) const {
+    size_t mask = table.size() - 1;
+    for (size_t i = (static_cast<uint32_t>(cell) * 2654435761u) & mask;; i = (i + 1) & mask) {
+        if (table[i].cell == cell) {
+            return &table[i];
+        }
+        if (table[i].cell == -1) {
+            return nullptr;
+        }
+    }
+}
+
+CooperativePlanner::GoalDistance::Slot& CooperativePlanner::GoalDistance::slot(int cell) {
+    if ((used + 1) * 10 > table.size() * 7) {
+        std::vector<Slot> old(table.size() * 2, Slot{ -1, 0 });
+        old.swap(table);
+        size_t mask = table.size() - 1;
+        for (const Slot& entry : old) {
+            if (entry.cell != -1) {
+                size_t i = (static_cast<uint32_t>(entry.cell) * 2654435761u) & mask;
+                while (table[i].cell != -1) {
+                    i = (i + 1) & mask;
+                }
+                table[i] = entry;
+            }
+        }
+    }
+
+    size_t mask = table.size() - 1;
+    size_t i = (static_cast<uint32_t>(cell) * 2654435761u) & mask;
+    while (table[i].cell != cell && table[i].cell != -1) {
+        i = (i + 1) & mask;
+    }
+    if (table[i].cell == -1) {
+        table[i] = Slot{ cell, infinity };
+        ++used;
+    }
+    return table[i];
+}
+
+int CooperativePlanner::GoalDistance::distance(const GridView& grid, int cell, unsigned long long& expanded) {
+    const Slot* known = find(cell);
+    if (known != nullptr && known->g < 0) {
+        return ~known->g;
+    }
+
+    // Searching backwards, stepping from y onto x costs what entering x
+    // costs. Cells come off the open list with their exact distance, so the
+    // search just goes on until it closes the cell asked for.
+    while (!open.empty()) {
+        int f = open.top().first;
+        int current = open.top().second;
+        open.pop();
+        Slot& entry = slot(current);
+        if (entry.g < 0 || f != entry.g + heuristic(current)) {
+            continue;  // stale duplicate
+        }
+        int g = entry.g;
+        entry.g = ~g;
+        ++expanded;
+
+        int next = g + grid.cost(current);
+        for (int offset : { 1, -1, stride, -stride }) {
+            int neighbor = current + offset;
+            if (grid.isWall(neighbor)) {
+                continue;
+            }
+            Slot& reached = slot(neighbor);  // may move entry, which is done with
+            if (reached.g < 0 || reached.g <= next) {
+                continue;
+            }
+            reached.g = next;
+            open.push({ next + heuristic(neighbor), neighbor });
+        }
+
+        if (current == cell) {
+            return g;
+        }
+    }
+    return infinity;
+}
+
+CooperativePlanner::CooperativePlanner(int window, int replanInterval)
+    : windowSize(std::max(window, 1)),
+      replanInterval(replanInterval > 0 ? std::min(replanInterval, std::max(window, 1)) : std::max(window / 2, 1)),
+      reservations(std::max(window, 1) + 1) {}
+
+void CooperativePlanner::reset(const GridView& newGrid, const std::vector<Point>& starts, const std::vector<Point>& goals) {
+    if (starts.size() != goals.size()) {
+        throw std::invalid_argument("Every agent needs a start and a goal");
+    }
+
+    std::unordered_set<int> startCells;
+    std::unordered_set<int> goalCells;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        if (!newGrid.contains(starts[i]) || !newGrid.contains(goals[i])) {
+            throw std::out_of_range("Invalid cell position");
+        }
+        if (newGrid.isWall(newGrid.index(starts[i])) || newGrid.isWall(newGrid.index(goals[i]))) {
+            throw std::invalid_argument("Agents cannot start or end on a wall");
+        }
+        if (!startCells.insert(newGrid.index(starts[i])).second || !goalCells.insert(newGrid.index(goals[i])).second) {
+            throw std::invalid_argument("Two agents share a start or a goal");
+        }
+    }
+
+    grid = newGrid;
+    now = 0;
+    lastEpisode = -replanInterval;
+    arrived = 0;
+    stats = Statistics();
+    agents.assign(starts.size(), Agent());
+    current = starts;
+    for (size_t i = 0; i < agents.size(); ++i) {
+        Agent& agent = agents[i];
+        agent.position = grid.index(starts[i]);
+        agent.goal = grid.index(goals[i]);
+        agent.plan.assign(1, agent.position);
+        agent.distance.reset(grid, agent.goal, agent.position);
+        if (agent.position == agent.goal) {
+            agent.arrival = 0;
+            ++arrived;
+        }
+    }
+}
+
+void CooperativePlanner::step() {
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    if (now - lastEpisode >= replanInterval) {
+        replanAll();
+    }
+    else {
+        // the others keep their plans; those that got stuck try again, all
+        // of them visible to each other before the first one plans
+        reservations.advance(now);
+        order.clear();
+        for (size_t id = 0; id < agents.size(); ++id) {
+            if (agents[id].failed) {
+                order.push_back(static_cast<int>(id));
+                releasePlan(static_cast<int>(id));
+            }
+        }
+        for (int id : order) {
+            holdPosition(id);
+        }
+        for (int id : order) {
+            plan(id);
+        }
+    }
+    stats.planMicros += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+    moveAgents();
+}
+
+void CooperativePlanner::holdPosition(int id) {
+    // Where an agent stands now and, until it has planned, the step after:
+    // nobody planned before it may walk into it or stand where it cannot
+    // leave yet.
+    const Agent& agent = agents[id];
+    for (int time = now; time <= now + 1; ++time) {
+        if (reservations.reservedBy(agent.position, time) == ReservationTable::none) {
+            reservations.reserve(agent.position, time, id);
+        }
+    }
+}
+
+void CooperativePlanner::releasePlan(int id) {
+    const Agent& agent = agents[id];
+    for (size_t depth = 1; depth < agent.plan.size(); ++depth) {
+        int time = agent.planStart + static_cast<int>(depth);
+        if (time > now) {
+            reservations.release(agent.plan[depth], time, id);
+        }
+    }
+}
+
+void CooperativePlanner::replanAll() {
+    lastEpisode = now;
+    ++stats.episodes;
+    reservations.clear(now);
+    for (size_t id = 0; id < agents.size(); ++id) {
+        holdPosition(static_cast<int>(id));
+    }
+
+    // Agents still under way go first, in an order rotating every batch;
+    // those already home come last, so they step aside rather than block.
+    order.clear();
+    for (size_t id = 0; id < agents.size(); ++id) {
+        if (agents[id].arrival == -1) {
+            order.push_back(static_cast<int>(id));
+        }
+    }
+    if (!order.empty()) {
+        std::rotate(order.begin(), order.begin() + stats.episodes % order.size(), order.end());
+    }
+    for (size_t id = 0; id < agents.size(); ++id) {
+        if (agents[id].arrival != -1) {
+            order.push_back(static_cast<int>(id));
+        }
+    }
+
+    for (int id : order) {
+        plan(id);
+    }
+}
+
+void CooperativePlanner::plan(int id) {
+    Agent& agent = agents[id];
+    ++stats.searches;
+    agent.planStart = now;
+
+    int startDistance = agent.distance.distance(grid, agent.position, stats.distanceExpanded);
+    if (startDistance >= infinity) {
+        // the goal is walled off: stay put, visibly so to everyone planning after
+        agent.failed = false;
+        agent.plan.assign(1, agent.position);
+        for (int time = now + 1; time <= now + windowSize; ++time) {
+            if (reservations.reservedBy(agent.position, time) == ReservationTable::none) {
+                reservations.reserve(agent.position, time, id);
+            }
+        }
+        return;
+    }
+
+    nodes.clear();
+    nodeAt.clear();
+    openList.clear();
+    nodes.push_back({ agent.position, 0, 0, -1, false });
+    openList.push_back({ startDistance, 0, 0 });
+
+    // Space-time A*: a node is a cell at a step. Waiting costs 1 except on
+    // the goal, so an agent that can stay home through the window does.
+    // Reaching the end of the window ends the search; the distance to the
+    // goal from there is exact, so the result is the best window start.
+    int found = -1;
+    while (!openList.empty()) {
+        std::pop_heap(openList.begin(), openList.end());
+        int current = openList.back().node;
+        openList.pop_back();
+        if (nodes[current].closed) {
+            continue;
+        }
+        nodes[current].closed = true;
+        ++stats.expanded;
+
+        int cell = nodes[current].cell;
+        int depth = nodes[current].depth;
+        int g = nodes[current].g;
+        if (depth == windowSize) {
+            found = current;
+            break;
+        }
+
+        int time = now + depth + 1;
+        for (int offset : { 0, 1, -1, grid.stride, -grid.stride }) {
+            int next = cell + offset;
+            if (grid.isWall(next)) {
+                continue;
+            }
+            int holder = reservations.reservedBy(next, time);
+            if (holder != ReservationTable::none && holder != id) {
+                continue;
+            }
+            if (offset != 0) {
+                // no swapping places with whoever comes the other way
+                int oncoming = reservations.reservedBy(next, time - 1);
+                if (oncoming != ReservationTable::none && oncoming != id && reservations.reservedBy(cell, time) == oncoming) {
+                    continue;
+                }
+            }
+
+            int remaining = agent.distance.distance(grid, next, stats.distanceExpanded);
+            if (remaining >= infinity) {
+                continue;
+            }
+            int nextG = g + (offset != 0 ? grid.cost(next) : (cell == agent.goal ? 0 : 1));
+            long long key = static_cast<long long>(next) * (windowSize + 1) + depth + 1;
+            auto known = nodeAt.find(key);
+            int node;
+            if (known != nodeAt.end()) {
+                node = known->second;
+                if (nodes[node].closed || nodes[node].g <= nextG) {
+                    continue;
+                }
+                nodes[node].g = nextG;
+                nodes[node].parent = current;
+            }
+            else {
+                node = static_cast<int>(nodes.size());
+                nodeAt.emplace(key, node);
+                nodes.push_back({ next, depth + 1, nextG, current, false });
+            }
+            openList.push_back({ nextG + remaining, depth + 1, node });
+            std::push_heap(openList.begin(), openList.end());
+        }
+    }
+
+    if (found == -1) {
+        // boxed in for now: wait on the held cell and try again next step
+        ++stats.failedSearches;
+        agent.failed = true;
+        agent.plan.assign(1, agent.position);
+        return;
+    }
+
+    agent.failed = false;
+    agent.plan.assign(windowSize + 1, agent.position);
+    for (int node = found; node != -1; node = nodes[node].parent) {
+        agent.plan[nodes[node].depth] = nodes[node].cell;
+    }
+    reservations.release(agent.position, now + 1, id);
+    for (int depth = 1; depth <= windowSize; ++depth) {
+        reservations.reserve(agent.plan[depth], now + depth, id);
+    }
+}
+
+void CooperativePlanner::moveAgents() {
+    next.resize(agents.size());
+    staying.clear();
+    for (size_t id = 0; id < agents.size(); ++id) {
+        const Agent& agent = agents[id];
+        size_t index = static_cast<size_t>(now + 1 - agent.planStart);
+        next[id] = index < agent.plan.size() ? agent.plan[index] : agent.plan.back();
+        if (next[id] == agent.position) {
+            staying.emplace(agent.position, static_cast<int>(id));
+        }
+    }
+
+    // Plans never meet, but an agent that could not plan stays where others
+    // may mean to go. Those wait as well, until nobody moves into a cell
+    // that stays taken.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t id = 0; id < agents.size(); ++id) {
+            Agent& agent = agents[id];
+            if (next[id] != agent.position && staying.count(next[id]) != 0) {
+                next[id] = agent.position;
+                staying.emplace(agent.position, static_cast<int>(id));
+                agent.failed = true;
+                ++stats.heldBack;
+                changed = true;
+            }
+        }
+    }
+
+    ++now;
+    for (size_t id = 0; id < agents.size(); ++id) {
+        Agent& agent = agents[id];
+        agent.position = next[id];
+        current[id] = grid.point(agent.position);
+        if (agent.position == agent.goal && agent.arrival == -1) {
+            agent.arrival = now;
+            ++arrived;
+        }
+        else if (agent.position != agent.goal && agent.arrival != -1) {
+            agent.arrival = -1;
+            --arrived;
+        }
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef COOPERATIVEPLANNER_H
+#define COOPERATIVEPLANNER_H
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+#include "Point.h"
+#include "GridStorage.h"
+#include "ReservationTable.h"
+
+// Windowed Hierarchical Cooperative A* (Silver, "Cooperative Pathfinding"):
+// moves many agents on one grid at once without two of them ever sharing a
+// cell or swapping places. Agents plan one after another through space and
+// time, each around the moves the ones before it reserved, but only window
+// steps ahead; past the window the exact distance to the goal stands in for
+// the rest of the route. Every replanInterval steps all agents replan in one
+// batch against a fresh reservation table, each time in a different order so
+// no agent is always the one giving way.
+// 4-connected; an agent moves one cell or waits per step, and the terrain
+// cost of the cells it enters is what it minimizes.
+class CooperativePlanner {
+public:
+    struct Statistics {
+        unsigned long long episodes = 0;          // batches in which every agent replanned
+        unsigned long long searches = 0;
+        unsigned long long failedSearches = 0;    // no way through the window: the agent waited
+        unsigned long long heldBack = 0;          // moves turned into waits, see step()
+        unsigned long long expanded = 0;          // space-time nodes
+        unsigned long long distanceExpanded = 0;  // cells expanded for the goal distances
+        double planMicros = 0.0;
+    };
+
+    // replanInterval 0 picks half the window.
+    explicit CooperativePlanner(int window = 16, int replanInterval = 0);
+
+    // Starts over with one agent per start/goal pair at time 0. Starts must
+    // be passable and distinct, as must goals. grid must outlive the planner
+    // or the next reset.
+    void reset(const GridView& grid, const std::vector<Point>& starts, const std::vector<Point>& goals);
+
+    // Moves every agent one step, replanning first where it is due. An agent
+    // boxed in by the agents planned before it waits, and whoever planned to
+    // walk into its cell waits too; those replan on the next step. So agents
+    // never share a cell or swap places, though in one-wide corridors they
+    // can block each other for good, as WHCA* does.
+    void step();
+
+    int time() const { return now; }
+    int window() const { return windowSize; }
+    size_t agentCount() const { return agents.size(); }
+    const std::vector<Point>& positions() const { return current; }
+    // Step the agent reached its goal and has stayed there since, -1 if it is not there.
+    int arrivalTime(int agent) const { return agents[agent].arrival; }
+    bool allArrived() const { return arrived == agents.size(); }
+    const Statistics& statistics() const { return stats; }
+
+private:
+    static constexpr int infinity = 0x3fffffff;
+
+    // Exact cost from any cell to one goal, computed on demand by an A*
+    // backwards from the goal towards the agent's start that resumes when
+    // asked for a cell it has not closed yet (Reverse Resumable A*).
+    class GoalDistance {
+    public:
+        void reset(const GridView& grid, int goal, int target);
+        int distance(const GridView& grid, int cell, unsigned long long& expanded);
+
+    private:
+        // Open addressing, 8 bytes a cell: with a thousand agents each
+        // holding thousands of cells, a node-based map is most of the memory.
+        struct Slot {
+            int cell;
+            int g;  // ~g once closed
+        };
+        using Queued = std::pair<int, int>;  // f, cell
+
+        int stride = 0;
+        int target = 0;
+        std::vector<Slot> table;
+        size_t used = 0;
+        std::priority_queue<Queued, std::vector<Queued>, std::greater<Queued>> open;
+
+        const Slot* find(int cell) const;
+        Slot& slot(int cell);  // inserted with g = infinity if missing
+        int heuristic(int cell) const;
+    };
+
+    struct Agent {
+        int position = 0;             // cell index
+        int goal = 0;
+        std::vector<int> plan;        // cells from planStart on
+        int planStart = 0;
+        bool failed = false;          // off its plan: replans next step
+        int arrival = -1;
+        GoalDistance distance;
+    };
+
+    // A cell at a step of the window, searched for one agent.
+    struct Node {
+        int cell;
+        int depth;  // steps after the search began
+        int g;
+        int parent;
+        bool closed;
+    };
+
+    struct Queued {
+        int f;
+        int depth;
+        int node;
+
+        // min-heap on f; deeper first among equals, which reaches the end of the window sooner
+        bool operator<(const Queued& other) const {
+            return f > other.f || (f == other.f && depth < other.depth);
+        }
+    };
+
+    int windowSize;
+    int replanInterval;
+    GridView grid;
+    int now = 0;
+    int lastEpisode = 0;
+    size_t arrived = 0;
+    std::vector<Agent> agents;
+    std::vector<Point> current;
+    ReservationTable reservations;
+    Statistics stats;
+
+    // scratch shared by every search of a batch
+    std::vector<int> order;
+    std::vector<Node> nodes;
+    std::unordered_map<long long, int> nodeAt;  // cell * (window + 1) + depth
+    std::vector<Queued> openList;
+    std::vector<int> next;
+    std::unordered_map<int, int> staying;  // cell, agent
+
+    void replanAll();
+    void plan(int id);
+    void holdPosition(int id);
+    void releasePlan(int id);
+    void moveAgents();
+};
+
+#endif  // COOPERATIVEPLANNER_H
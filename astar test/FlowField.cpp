@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <functional>
+#include "FlowField.h"
+
+FlowField::FlowField(unsigned threadCount, int tileSize) : threads(threadCount), tileSize(std::max(tileSize, 1)) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+}
+
+WorkerPool& FlowField::pool() {
+    if (!workers.pool) {
+        workers.pool = std::make_unique<WorkerPool>(threads);
+        heaps.resize(threads);
+        outbox.resize(threads);
+    }
+    return *workers.pool;
+}
+
+int FlowField::tileOf(int cell) const {
+    int row = cell / stride - 1;
+    int col = cell % stride - 1;
+    return (row / tileSize) * tilesAcross + col / tileSize;
+}
+
+void FlowField::activate(int tile) {
+    if (!activeFlag[tile]) {
+        activeFlag[tile] = 1;
+        active.push_back(tile);
+    }
+}
+
+void FlowField::touch(int tile) {
+    touchedFlag[tile] = 1;
+}
+
+void FlowField::build(const GridView& grid, const Point& goal) {
+    built = true;
+    this->goal = goal;
+    rows = grid.rows;
+    cols = grid.cols;
+    stride = grid.stride;
+    offsets[0] = 1;
+    offsets[1] = -1;
+    offsets[2] = stride;
+    offsets[3] = -stride;
+    tilesAcross = (cols + tileSize - 1) / tileSize;
+    tilesDown = (rows + tileSize - 1) / tileSize;
+
+    size_t tiles = static_cast<size_t>(tilesAcross) * tilesDown;
+    seeds.resize(tiles);
+    for (auto& tileSeeds : seeds) {
+        tileSeeds.clear();
+    }
+    activeFlag.assign(tiles, 0);
+    touchedFlag.assign(tiles, 0);
+    active.clear();
+
+    int cellCount = grid.empty() ? 0 : grid.cellCount();
+    dist.assign(cellCount, unreachable);
+    step.assign(cellCount, noStep);
+    known.assign(grid.cells, grid.cells + cellCount);
+    pending.clear();
+    stale = false;
+    rounds = 0;
+    tileRuns = 0;
+
+    goalIndex = !grid.empty() && grid.contains(goal) ? grid.index(goal) : -1;
+    if (goalIndex >= 0 && !grid.isWall(goalIndex)) {
+        seeds[tileOf(goalIndex)].push_back({ 0, goalIndex });
+        activate(tileOf(goalIndex));
+        propagate(grid);
+    }
+    refreshSteps(grid, true);
+}
+
+void FlowField::cellChanged(int row, int col) {
+    if (!built || stale || row < 0 || row >= rows || col < 0 || col >= cols) {
+        return;
+    }
+
+    // past a few percent of the map a rebuild is cheaper than a repair
+    if (pending.size() * 16 < static_cast<size_t>(rows) * cols) {
+        pending.push_back((row + 1) * stride + col + 1);
+    }
+    else {
+        pending.clear();
+        stale = true;
+    }
+}
+
+void FlowField::update(const GridView& grid) {
+    rounds = 0;
+    tileRuns = 0;
+    if (stale) {
+        build(grid, goal);
+        return;
+    }
+    if (!built || pending.empty()) {
+        return;
+    }
+
+    edits.clear();
+    bool goalChanged = false;
+    for (int cell : pending) {
+        uint8_t before = known[cell];
+        uint8_t after = grid.at(cell);
+        if (before == after) {
+            continue;  // changed back, or listed twice
+        }
+        known[cell] = after;
+        edits.push_back({ cell, before });
+        goalChanged = goalChanged || cell == goalIndex;
+    }
+    pending.clear();
+
+    if (goalChanged) {
+        // every distance hangs off the goal's cost
+        build(grid, goal);
+        return;
+    }
+    if (edits.empty()) {
+        return;
+    }
+
+    // Dearer cells first: whatever routed through them only has an upper
+    // bound that is no longer achievable, so it starts over.
+    resetQueue.clear();
+    for (const auto& edit : edits) {
+        int cell = edit.first;
+        int before = edit.second == CELL_WALL ? unreachable : cellCost(edit.second);
+        int after = grid.isWall(cell) ? unreachable : grid.cost(cell);
+        if (after > before) {
+            resetDependents(cell, after == unreachable);
+        }
+    }
+    for (int cell : resetQueue) {
+        seedFromNeighbors(grid, cell);
+    }
+
+    // Cheaper cells: the cell itself if it just opened, its neighbors otherwise.
+    for (const auto& edit : edits) {
+        int cell = edit.first;
+        int before = edit.second == CELL_WALL ? unreachable : cellCost(edit.second);
+        int after = grid.isWall(cell) ? unreachable : grid.cost(cell);
+        if (after >= before) {
+            continue;
+        }
+        if (before == unreachable || dist[cell] == unreachable) {
+            seedFromNeighbors(grid, cell);  // reaching it spreads the new cost
+            continue;
+        }
+
+        int through = dist[cell] + after;
+        for (int offset : offsets) {
+            int neighbor = cell + offset;
+            if (!grid.isWall(neighbor) && through < dist[neighbor]) {
+                seeds[tileOf(neighbor)].push_back({ through, neighbor });
+                activate(tileOf(neighbor));
+            }
+        }
+    }
+
+    propagate(grid);
+    refreshSteps(grid, false);
+}
+
+void FlowField::resetDependents(int cell, bool self) {
+    size_t head = resetQueue.size();
+    if (self && dist[cell] != unreachable) {
+        dist[cell] = unreachable;
+        step[cell] = noStep;
+        touch(tileOf(cell));
+        resetQueue.push_back(cell);
+    }
+
+    // walk the step arrows backwards: every cell stepping onto a reset cell
+    int from = cell;
+    while (true) {
+        for (int offset : offsets) {
+            int child = from + offset;
+            int8_t back = step[child];
+            if (back != noStep && child + offsets[back] == from) {
+                dist[child] = unreachable;
+                step[child] = noStep;
+                touch(tileOf(child));
+                resetQueue.push_back(child);
+            }
+        }
+        if (head == resetQueue.size()) {
+            break;
+        }
+        from = resetQueue[head++];
+    }
+}
+
+void FlowField::seedFromNeighbors(const GridView& grid, int cell) {
+    if (grid.isWall(cell)) {
+        return;
+    }
+
+    int best = unreachable;
+    for (int offset : offsets) {
+        int neighbor = cell + offset;
+        if (dist[neighbor] != unreachable) {
+            best = std::min(best, dist[neighbor] + grid.cost(neighbor));
+        }
+    }
+    if (best < dist[cell]) {
+        seeds[tileOf(cell)].push_back({ best, cell });
+        activate(tileOf(cell));
+    }
+}
+
+void FlowField::propagate(const GridView& grid) {
+    WorkerPool& workerPool = pool();
+    std::function<void(size_t, unsigned)> runTile = [this, &grid](size_t item, unsigned worker) {
+        relaxTile(grid, active[item], worker);
+    };
+
+    while (!active.empty()) {
+        ++rounds;
+        tileRuns += static_cast<int>(active.size());
+        workerPool.run(active.size(), runTile);
+
+        for (int tile : active) {
+            activeFlag[tile] = 0;
+        }
+        active.clear();
+
+        // hand improvements across tile borders to the next round
+        for (auto& out : outbox) {
+            for (const Seed& seed : out) {
+                if (seed.first < dist[seed.second]) {
+                    int tile = tileOf(seed.second);
+                    seeds[tile].push_back(seed);
+                    activate(tile);
+                }
+            }
+            out.clear();
+        }
+    }
+}
+
+void FlowField::relaxTile(const GridView& grid, int tile, unsigned worker) {
+    // Only this tile's cells are written; anything crossing the border goes
+    // to the worker's outbox and is merged between rounds.
+    std::vector<Seed>& heap = heaps[worker];
+    std::vector<Seed>& out = outbox[worker];
+    auto later = std::greater<Seed>();
+
+    bool changed = false;
+    for (const Seed& seed : seeds[tile]) {
+        if (seed.first < dist[seed.second]) {
+            dist[seed.second] = seed.first;
+            heap.push_back(seed);
+            std::push_heap(heap.begin(), heap.end(), later);
+            changed = true;
+        }
+    }
+    seeds[tile].clear();
+
+    int rowBegin = (tile / tilesAcross) * tileSize;
+    int colBegin = (tile % tilesAcross) * tileSize;
+    int rowEnd = std::min(rowBegin + tileSize, rows);
+    int colEnd = std::min(colBegin + tileSize, cols);
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        Seed current = heap.back();
+        heap.pop_back();
+
+        int cell = current.second;
+        if (current.first != dist[cell]) {
+            continue;  // improved again since it was pushed
+        }
+
+        int row = cell / stride - 1;
+        int col = cell % stride - 1;
+        // same order as offsets: right, left, down, up
+        bool inside[4] = { col + 1 < colEnd, col > colBegin, row + 1 < rowEnd, row > rowBegin };
+
+        int through = current.first + grid.cost(cell);
+        for (int i = 0; i < 4; ++i) {
+            int neighbor = cell + offsets[i];
+            if (grid.isWall(neighbor)) {
+                continue;
+            }
+            if (!inside[i]) {
+                out.push_back({ through, neighbor });
+            }
+            else if (through < dist[neighbor]) {
+                dist[neighbor] = through;
+                heap.push_back({ through, neighbor });
+                std::push_heap(heap.begin(), heap.end(), later);
+            }
+        }
+    }
+
+    if (changed) {
+        touchedFlag[tile] = 1;
+    }
+}
+
+void FlowField::refreshSteps(const GridView& grid, bool all) {
+    // A step can change wherever a neighbor's distance did, so the tiles
+    // next to touched ones are redone as well.
+    refreshTiles.clear();
+    for (int tileRow = 0; tileRow < tilesDown; ++tileRow) {
+        for (int tileCol = 0; tileCol < tilesAcross; ++tileCol) {
+            int tile = tileRow * tilesAcross + tileCol;
+            bool near = touchedFlag[tile]
+                || (tileCol > 0 && touchedFlag[tile - 1])
+                || (tileCol + 1 < tilesAcross && touchedFlag[tile + 1])
+                || (tileRow > 0 && touchedFlag[tile - tilesAcross])
+                || (tileRow + 1 < tilesDown && touchedFlag[tile + tilesAcross]);
+            if (all || near) {
+                refreshTiles.push_back(tile);
+            }
+        }
+    }
+
+    pool().run(refreshTiles.size(), [this, &grid](size_t item, unsigned) {
+        refreshTile(grid, refreshTiles[item]);
+    });
+    std::fill(touchedFlag.begin(), touchedFlag.end(), 0);
+}
+
+void FlowField::refreshTile(const GridView& grid, int tile) {
+    int rowBegin = (tile / tilesAcross) * tileSize;
+    int colBegin = (tile % tilesAcross) * tileSize;
+    int rowEnd = std::min(rowBegin + tileSize, rows);
+    int colEnd = std::min(colBegin + tileSize, cols);
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        for (int col = colBegin; col < colEnd; ++col) {
+            int cell = (row + 1) * stride + col + 1;
+            int8_t bestStep = noStep;
+            if (cell != goalIndex && dist[cell] != unreachable) {
+                int best = unreachable;
+                for (int i = 0; i < 4; ++i) {
+                    int neighbor = cell + offsets[i];
+                    if (dist[neighbor] != unreachable && dist[neighbor] + grid.cost(neighbor) < best) {
+                        best = dist[neighbor] + grid.cost(neighbor);
+                        bestStep = static_cast<int8_t>(i);
+                    }
+                }
+            }
+            step[cell] = bestStep;
+        }
+    }
+}
+
+int FlowField::distance(const Point& p) const {
+    if (!built || p.x < 0 || p.x >= rows || p.y < 0 || p.y >= cols) {
+        return unreachable;
+    }
+    return dist[(p.x + 1) * stride + p.y + 1];
+}
+
+bool FlowField::nextStep(const Point& p, Point& next) const {
+    if (!built || p.x < 0 || p.x >= rows || p.y < 0 || p.y >= cols) {
+        return false;
+    }
+
+    int cell = (p.x + 1) * stride + p.y + 1;
+    if (step[cell] == noStep) {
+        return false;
+    }
+    int to = cell + offsets[step[cell]];
+    next = Point(to / stride - 1, to % stride - 1);
+    return true;
+}
+
+std::vector<Point> FlowField::pathFrom(const Point& p) const {
+    std::vector<Point> path;
+    if (distance(p) == unreachable) {
+        return path;
+    }
+
+    // distances drop by at least 1 per step, so this ends at the goal
+    Point current = p;
+    path.push_back(current);
+    while (nextStep(current, current)) {
+        path.push_back(current);
+    }
+    return path;
+}
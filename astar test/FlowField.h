@@ -0,0 +1,117 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <vector>
+#include <memory>
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include "Point.h"
+#include "GridStorage.h"
+#include "WorkerPool.h"
+
+// Distance to one goal from every cell, plus the step to take from each cell,
+// so any number of agents heading to that goal just follow the arrows in
+// O(path length) instead of searching once each. Honors terrain costs.
+//
+// The map is cut into square tiles and solved as a blocked Dijkstra: each
+// round, every active tile runs a local Dijkstra from the improvements it
+// received; what leaves the tile is handed to the neighbor tile for the next
+// round. Active tiles of a round run in parallel and only write their own
+// cells. Edits are repaired locally: cells whose route went through a
+// cell that got dearer are reset and refilled from around them, cells that
+// got cheaper seed new improvements.
+class FlowField {
+public:
+    static constexpr int unreachable = INT_MAX;
+
+    // threadCount includes the calling thread; 0 picks one per hardware thread.
+    explicit FlowField(unsigned threadCount = 0, int tileSize = 64);
+
+    // Full computation towards goal.
+    void build(const GridView& grid, const Point& goal);
+    bool isBuilt() const { return built; }
+    Point getGoal() const { return goal; }
+
+    // Marks a cell whose value changed; update() repairs the field.
+    void cellChanged(int row, int col);
+    // Applies the changes since the last build/update. grid must be the same
+    // grid (size and goal) the field was built for, in its current state.
+    void update(const GridView& grid);
+
+    // Cost of the cheapest way from p to the goal, unreachable if there is none.
+    int distance(const Point& p) const;
+    // Where to step from p; false at the goal and where the goal is unreachable.
+    bool nextStep(const Point& p, Point& next) const;
+    // Cells from p to the goal, p included; empty if unreachable.
+    std::vector<Point> pathFrom(const Point& p) const;
+
+    // Wavefront rounds and tile runs of the last build/update.
+    int lastRounds() const { return rounds; }
+    int lastTileRuns() const { return tileRuns; }
+    unsigned threadCount() const { return threads; }
+
+private:
+    static constexpr int8_t noStep = -1;
+
+    // Worker threads start on first use and are never copied along, which
+    // keeps classes holding a FlowField (like Grid) copyable.
+    struct PoolHandle {
+        std::unique_ptr<WorkerPool> pool;
+
+        PoolHandle() = default;
+        PoolHandle(const PoolHandle&) {}
+        PoolHandle& operator=(const PoolHandle&) {
+            pool.reset();  // the thread count may differ
+            return *this;
+        }
+    };
+
+    using Seed = std::pair<int, int>;  // distance, cell
+
+    unsigned threads;
+    int tileSize;
+    PoolHandle workers;
+
+    bool built = false;
+    Point goal;
+    int goalIndex = -1;  // -1 if goal is off the grid
+    int rows = 0;
+    int cols = 0;
+    int stride = 0;
+    int tilesAcross = 0;
+    int tilesDown = 0;
+    int offsets[4] = {};
+
+    std::vector<int> dist;       // per padded cell
+    std::vector<int8_t> step;    // per padded cell: index into offsets, or noStep
+    std::vector<uint8_t> known;  // cell values the field was computed for
+    std::vector<int> pending;    // changed cells not applied yet
+    bool stale = false;          // too many changes to repair: rebuild instead
+    std::vector<std::pair<int, uint8_t>> edits;  // cell, value before, during update()
+
+    std::vector<std::vector<Seed>> seeds;  // per tile, for the next round
+    std::vector<int> active;               // tiles to run this round
+    std::vector<uint8_t> activeFlag;       // per tile
+    std::vector<uint8_t> touchedFlag;      // per tile: distances changed, steps need a refresh
+    std::vector<std::vector<Seed>> heaps;  // per worker
+    std::vector<std::vector<Seed>> outbox; // per worker: improvements for other tiles
+    std::vector<int> resetQueue;
+    std::vector<int> refreshTiles;
+
+    int rounds = 0;
+    int tileRuns = 0;
+
+    WorkerPool& pool();
+    int tileOf(int cell) const;
+    void activate(int tile);
+    void touch(int tile);
+    void seedFromNeighbors(const GridView& grid, int cell);
+    void relaxTile(const GridView& grid, int tile, unsigned worker);
+    void propagate(const GridView& grid);
+    void refreshSteps(const GridView& grid, bool all);
+    void refreshTile(const GridView& grid, int tile);
+    void resetDependents(int cell, bool self);
+};
+
+#endif  // FLOWFIELD_H
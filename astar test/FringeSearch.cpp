@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <stdexcept>
+#include "FringeSearch.h"
+
+const std::pmr::vector<Point>& FringeSearch::findPath(const GridView& grid, const Point& start, const Point& goal) {
+    path.clear();
+    passes = 0;
+    recorder.begin();
+    if (grid.empty() || !grid.contains(start) || !grid.contains(goal)) {
+        recorder.end();
+        return path;
+    }
+    if (grid.cellCount() > maxCells) {
+        recorder.end();
+        throw std::invalid_argument("Grid too large for FringeSearch");
+    }
+
+    // 4 bytes a cell leave no room for generation stamps: clearing is one
+    // linear pass, cheap next to a search that needs this mode
+    cells.assign(static_cast<size_t>(grid.cellCount()), 0);
+    now.clear();
+    later.clear();
+
+    const int offsets[4] = { 1, -1, grid.stride, -grid.stride };
+    int startIndex = grid.index(start);
+    int goalIndex = grid.index(goal);
+    auto heuristic = [&](int index) {
+        return abs(index / grid.stride - goalIndex / grid.stride) + abs(index % grid.stride - goalIndex % grid.stride);
+    };
+
+    cells[startIndex] = 1u << 3 | listed;
+    now.push_back(startIndex);
+    recorder.pushed(1);
+
+    int threshold = heuristic(startIndex);
+    while (!now.empty()) {
+        ++passes;
+        int nextThreshold = INT_MAX;
+
+        while (!now.empty()) {
+            int current = static_cast<int>(now.back());
+            now.pop_back();
+
+            // pushed again since, with a better g, and handled there
+            uint32_t word = cells[current];
+            if (!(word & listed)) {
+                recorder.stalePop();
+                continue;
+            }
+
+            int currentG = g(word);
+            int f = currentG + heuristic(current);
+            if (f > threshold) {
+                nextThreshold = std::min(nextThreshold, f);
+                later.push_back(current);  // stays listed
+                continue;
+            }
+
+            cells[current] = word & ~listed;
+            recorder.expanded(grid, current);
+            if (current == goalIndex) {
+                reconstructPath(grid, startIndex, goalIndex, offsets);
+                recorder.end();
+                return path;
+            }
+
+            for (uint32_t direction = 0; direction < 4; ++direction) {
+                int neighbor = current + offsets[direction];
+                if (grid.isWall(neighbor)) {
+                    continue;
+                }
+
+                uint32_t neighborWord = cells[neighbor];
+                if (neighborWord != 0 && currentG + 1 >= g(neighborWord)) {
+                    continue;
+                }
+                if (neighborWord != 0 && !(neighborWord & listed)) {
+                    recorder.reopened();
+                }
+
+                // depth first: on top of the stack, so it comes next
+                cells[neighbor] = static_cast<uint32_t>(currentG + 2) << 3 | listed | direction;
+                now.push_back(neighbor);
+                recorder.pushed(now.size() + later.size());
+            }
+        }
+
+        threshold = nextThreshold;
+        now.swap(later);
+    }
+
+    recorder.end();
+    return path;  // no path found
+}
+
+void FringeSearch::reconstructPath(const GridView& grid, int startIndex, int goalIndex, const int (&offsets)[4]) {
+    for (int current = goalIndex; ; current -= offsets[cells[current] & directionMask]) {
+        path.push_back(grid.point(current));
+        if (current == startIndex) {
+            break;
+        }
+    }
+
+    std::reverse(path.begin(), path.end());
+}
@@ -0,0 +1,61 @@
+#ifndef FRINGESEARCH_H
+#define FRINGESEARCH_H
+
+#include <vector>
+#include <cstdint>
+#include <memory_resource>
+#include "Point.h"
+#include "GridStorage.h"
+#include "SearchStats.h"
+
+// Fringe Search (Björnsson, Enzenberger, Holte, Schaeffer): A* without a
+// priority queue, for grids too large for the per-cell state of AStar (about
+// 20 bytes a cell). Like IDA* it works in passes with an f threshold, going
+// depth first through every cell within it; cells beyond it wait in a plain
+// list for the next pass, whose threshold is the smallest f that did not fit.
+// Unlike IDA* every cell remembers its g, so no pass repeats the one before.
+// The state is one 32-bit word a cell (g, parent direction and a flag) plus
+// the two lists, which only ever hold the frontier: memory is
+// bytesPerCell * GridView::cellCount() plus a few bytes per frontier cell,
+// whatever the query. Paths are optimal: as long as AStar's Standard ones.
+// 4-connected, every passable cell costs 1.
+class FringeSearch {
+public:
+    static constexpr size_t bytesPerCell = sizeof(uint32_t);
+
+    explicit FringeSearch(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : cells(resource), now(resource), later(resource), path(resource) {}
+
+    // Empty if there is no path. Result stays valid until the next query.
+    // Throws std::invalid_argument for grids with more than maxCells cells.
+    const std::pmr::vector<Point>& findPath(const GridView& grid, const Point& start, const Point& goal);
+
+    // g is stored in 29 bits and never exceeds the cell count.
+    static constexpr int maxCells = (1 << 29) - 2;
+
+    // Threshold passes of the last query.
+    int lastPasses() const { return passes; }
+    // Bytes held between queries: the cell words and the capacity of the lists.
+    size_t memoryBytes() const { return (cells.capacity() + now.capacity() + later.capacity()) * sizeof(uint32_t); }
+
+    // A reopening is a cell expanded again because a shorter way to it showed up.
+    const SearchStats& lastStats() const { return recorder.stats(); }
+    void setTrace(SearchTrace callback, void* user = nullptr) { recorder.setTrace(callback, user); }
+
+private:
+    // cell word: (g + 1) << 3 | listed << 2 | direction it was entered in; 0 is unvisited
+    static constexpr uint32_t listed = 4;
+    static constexpr uint32_t directionMask = 3;
+
+    std::pmr::vector<uint32_t> cells;
+    std::pmr::vector<uint32_t> now;    // cells within the threshold, a stack
+    std::pmr::vector<uint32_t> later;  // cells for the next pass
+    std::pmr::vector<Point> path;
+    int passes = 0;
+    SearchRecorder recorder;
+
+    static int g(uint32_t word) { return static_cast<int>(word >> 3) - 1; }
+    void reconstructPath(const GridView& grid, int startIndex, int goalIndex, const int (&offsets)[4]);
+};
+
+#endif  // FRINGESEARCH_H
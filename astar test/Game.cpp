@@ -1,4 +1,5 @@
 #include "Game.h"
+#include <climits>
 #include <stdexcept>
 #include <iostream>
 
@@ -9,20 +10,67 @@ Mouse::Mouse() {
     lButtonDown = false;
 }
 
-Grid::Grid(int nRows, int nCols, int sqSize, int sqSpacing) : rows(nRows), cols(nCols), size(sqSize), spacing(sqSpacing) {
+Grid::Grid(int nRows, int nCols, int sqSize, int sqSpacing) : size(sqSize), rows(nRows), cols(nCols), spacing(sqSpacing) {
     // Initialize the grid with 0s
-    grid.resize(rows, std::vector<int>(cols, 0));
-    start.x = 0;
-    start.y = 0;
-    finish.x = nCols - 1;
-    finish.y = nRows - 1;
+    grid = GridStorage(rows, cols, 0);
+    components.build(grid.view());
+    on_path.resize(static_cast<size_t>(rows) * cols, false);
+    in_redraw_log.resize(static_cast<size_t>(rows) * cols, false);
+    // x is the row everywhere: the finish is the bottom-right cell
+    start = { 0, 0 };
+    finish = { rows - 1, cols - 1 };
+}
+
+Grid::Grid(const GridView& cells, int sqSize, int sqSpacing) : Grid(0, 0, sqSize, sqSpacing) {
+    rows = cells.rows;
+    cols = cells.cols;
+    grid = GridStorage(cells);
+    components.build(grid.view());
+    on_path.assign(static_cast<size_t>(rows) * cols, false);
+    in_redraw_log.assign(static_cast<size_t>(rows) * cols, false);
+    finish = { rows - 1, cols - 1 };
 }
 
 void Grid::setCell(int row, int col, int value) {
     // Check if the given row and column are within bounds
     if (row >= 0 && row < rows && col >= 0 && col < cols) {
-        // Check if the value is valid (0, 1, or 2)
-        grid[row][col] = value;
+        if (grid.get(row, col) != value) {
+            // walls cost "infinitely" much to enter
+            int oldCost = grid.get(row, col) == CELL_WALL ? INT_MAX : cellCost(grid.get(row, col));
+            int newCost = value == CELL_WALL ? INT_MAX : cellCost(static_cast<uint8_t>(value));
+            grid.set(row, col, static_cast<uint8_t>(value));
+            ++version;
+            hierarchy.cellChanged(row, col);
+            flow_field.cellChanged(row, col);
+            anytime.invalidate();
+
+            if (!in_redraw_log[row * cols + col]) {
+                in_redraw_log[row * cols + col] = true;
+                redraw_log.emplace_back(row, col);
+            }
+
+            if (oldCost == INT_MAX && newCost != INT_MAX) {
+                components.cellOpened(grid.view(), row, col);
+            }
+            else if (oldCost != INT_MAX && newCost == INT_MAX) {
+                components.cellBlocked(grid.view(), row, col);
+            }
+
+            // a cell getting dearer off the cached path cannot make it longer or
+            // wrong, but a cheaper one (or an opened wall) may create a shortcut
+            if ((newCost > oldCost && on_path[row * cols + col]) || newCost < oldCost) {
+                cache_valid = false;
+            }
+
+            // past a few percent of the map a fresh search is cheaper than a repair
+            if (change_log.size() * 16 < static_cast<size_t>(rows) * cols) {
+                change_log.emplace_back(row, col);
+            }
+            else {
+                change_log.clear();
+                path_finder.invalidate();
+            }
+        }
     }
     else {
         // Invalid row or column
@@ -33,7 +81,7 @@ void Grid::setCell(int row, int col, int value) {
 int Grid::getCell(int row, int col) const {
     // Check if the given row and column are within bounds
     if (row >= 0 && row < rows && col >= 0 && col < cols) {
-        return grid[row][col];
+        return grid.get(row, col);
     }
     else {
         // Invalid row or column
@@ -41,10 +89,82 @@ int Grid::getCell(int row, int col) const {
     }
 }
 
-std::vector<Point> Grid::findPath() {
-    return path_finder.findPath(grid, start, finish);
+bool Grid::squareAt(int pixelX, int pixelY, Point& square) const {
+    int pitch = size + spacing;
+    if (pixelX < 0 || pixelY < 0 || pixelX % pitch >= size || pixelY % pitch >= size) {
+        // over the spacing, not a valid square
+        return false;
+    }
+    // pixels run along columns, Point.x is the row
+    Point p(pixelY / pitch, pixelX / pitch);
+    if (p.x >= rows || p.y >= cols) {
+        return false;
+    }
+    square = p;
+    return true;
 }
 
+const std::pmr::vector<Point>& Grid::findPath() {
+    if (cache_valid && start == cached_start && finish == cached_finish) {
+        ++cache_hits;
+        return cached_path;
+    }
+    ++cache_misses;
+
+    for (const Point& p : cached_path) {
+        on_path[p.x * cols + p.y] = false;
+    }
+
+    // A walled-off finish would make the search flood everything the start
+    // can reach. A painted-over start is still a valid source for the
+    // planner, so that case is left to it. The change log stays for the
+    // next real search.
+    GridView view = grid.view();
+    if (view.contains(start) && !view.isWall(view.index(start)) && !components.connected(view, start, finish)) {
+        ++unreachable_skips;
+        cached_path.clear();
+    }
+    else {
+        cached_path = path_finder.findPath(view, start, finish, change_log);
+        change_log.clear();
+    }
+
+    for (const Point& p : cached_path) {
+        on_path[p.x * cols + p.y] = true;
+    }
+    cached_start = start;
+    cached_finish = finish;
+    cache_valid = true;
+
+    return cached_path;
+}
+
+std::vector<Point> Grid::findPathHierarchical() {
+    return hierarchy.findPath(grid.view(), start, finish);
+}
+
+std::vector<Point> Grid::takeRedrawLog() {
+    for (const Point& p : redraw_log) {
+        in_redraw_log[p.x * cols + p.y] = false;
+    }
+    std::vector<Point> cells;
+    cells.swap(redraw_log);
+    return cells;
+}
+
+const std::pmr::vector<Point>& Grid::findPathAnytime(const ARAStar::Budget& budget) {
+    return anytime.findPath(grid.view(), start, finish, budget);
+}
+
+const FlowField& Grid::getFlowField() {
+    if (!flow_field.isBuilt() || !(flow_field.getGoal() == finish)) {
+        flow_field.build(grid.view(), finish);
+    }
+    else {
+        flow_field.update(grid.view());
+    }
+    return flow_field;
+}
 
 Game::Game(Grid g) : grid(g) {
 
@@ -1,9 +1,13 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include <Windows.h>
 #include <vector>
 #include "AStar.h"
+#include "LPAStar.h"
+#include "ARAStar.h"
+#include "HPAStar.h"
+#include "ComponentIndex.h"
+#include "FlowField.h"
 
 class Mouse {
 public:
@@ -17,8 +21,26 @@ public:
 
 class Grid {
 private:
-    std::vector<std::vector<int>> grid;
-    AStar path_finder;
+    GridStorage grid;
+    LPAStar path_finder;  // keeps its search tree between findPath calls
+    std::vector<Point> change_log;  // cells edited since the last findPath
+    std::vector<Point> redraw_log;  // cells edited since the last takeRedrawLog, each once
+    std::vector<bool> in_redraw_log;  // per cell (row * cols + col)
+    HPAStar hierarchy;  // built on the first findPathHierarchical call
+    ComponentIndex components;  // kept current by setCell; rules out walled-off goals in O(1)
+    FlowField flow_field;  // built on the first getFlowField call, then repaired
+    ARAStar anytime;  // refined a little per findPathAnytime call, restarted by edits
+
+    // last findPath result, reused until an edit could change it
+    std::pmr::vector<Point> cached_path;
+    std::vector<bool> on_path;  // per cell (row * cols + col): part of cached_path
+    bool cache_valid = false;
+    Point cached_start;
+    Point cached_finish;
+    unsigned long long version = 0;  // bumped on every cell change
+    unsigned long long cache_hits = 0;
+    unsigned long long cache_misses = 0;
+    unsigned long long unreachable_skips = 0;
 
 public:
     int size;
@@ -30,9 +52,40 @@ public:
     Point finish;
 
     Grid(int nRows, int nCols, int sqSize, int sqSpacing);
+    // Starts from a copy of a loaded map instead of an empty grid.
+    Grid(const GridView& cells, int sqSize, int sqSpacing);
     void setCell(int row, int col, int value);
     int getCell(int row, int col) const;
-    std::vector<Point> findPath();
+    // The cell drawn at a window pixel, as (row, col); false over the spacing
+    // or outside the grid.
+    bool squareAt(int pixelX, int pixelY, Point& square) const;
+    // Start and finish, which mouse edits leave alone.
+    bool isEndpoint(const Point& p) const { return p == start || p == finish; }
+    GridView view() const { return grid.view(); }
+    // Cells edited since the last call, for renderers that only repaint what changed.
+    std::vector<Point> takeRedrawLog();
+    const std::pmr::vector<Point>& findPath();
+    // Near-optimal path from the cluster hierarchy, for grids too large for findPath.
+    std::vector<Point> findPathHierarchical();
+    // Best path found within budget; later calls keep improving it until
+    // getAnytimeSearch().isFinished(). For frame-bounded callers.
+    const std::pmr::vector<Point>& findPathAnytime(const ARAStar::Budget& budget);
+    const ARAStar& getAnytimeSearch() const { return anytime; }
+    // Steps towards finish from every cell, for many agents sharing that goal.
+    // Edits since the last call are repaired, a moved finish rebuilds it.
+    const FlowField& getFlowField();
+    unsigned long long getVersion() const { return version; }
+    unsigned long long getCacheHits() const { return cache_hits; }
+    unsigned long long getCacheMisses() const { return cache_misses; }
+    // findPath calls answered by the component index without searching.
+    unsigned long long getUnreachableSkips() const { return unreachable_skips; }
+    int getComponentCount() const { return components.componentCount(); }
+    // Work of the last search findPath ran; cache hits do not search.
+    const SearchStats& getSearchStats() const { return path_finder.lastStats(); }
+    void setSearchTrace(SearchTrace callback, void* user = nullptr) {
+        path_finder.setTrace(callback, user);
+        anytime.setTrace(callback, user);
+    }
 };
 
 class Game
@@ -0,0 +1,189 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include "GridFile.h"
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char gridMagic[8] = { 'A', 'S', 'T', 'G', 'R', 'I', 'D', '\n' };
+    constexpr uint32_t gridVersion = 1;
+    constexpr uint32_t gridByteOrder = 0x01020304;
+
+    struct GridFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t rows;
+        uint32_t cols;
+        uint32_t cellOffset;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(GridFileHeader) == 32, "the header layout is part of the file format");
+
+    // The border is what keeps searches inside the buffer, so a damaged file
+    // must not get past it.
+    bool hasWallBorder(const GridView& grid) {
+        int last = (grid.rows + 1) * grid.stride;
+        for (int col = 0; col < grid.stride; ++col) {
+            if (!grid.isWall(col) || !grid.isWall(last + col)) {
+                return false;
+            }
+        }
+        for (int row = 1; row <= grid.rows; ++row) {
+            if (!grid.isWall(row * grid.stride) || !grid.isWall(row * grid.stride + grid.stride - 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+GridFile::GridFile(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open grid file: " + path);
+    }
+    fileHandle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(GridFileHeader))) {
+        close();
+        throw std::runtime_error("Invalid grid file: " + path);
+    }
+    mappedBytes = static_cast<size_t>(size.QuadPart);
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle != nullptr) {
+        mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Cannot open grid file: " + path);
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(GridFileHeader))) {
+        ::close(file);
+        throw std::runtime_error("Invalid grid file: " + path);
+    }
+    mappedBytes = static_cast<size_t>(info.st_size);
+
+    // shared and read-only: every process mapping the file uses the same pages
+    void* pages = mmap(nullptr, mappedBytes, PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);  // the mapping keeps the file alive
+    if (pages != MAP_FAILED) {
+        mapping = pages;
+    }
+#endif
+    if (mapping == nullptr) {
+        close();
+        throw std::runtime_error("Cannot map grid file: " + path);
+    }
+
+    GridFileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    bool valid = std::memcmp(header.magic, gridMagic, sizeof(gridMagic)) == 0
+        && header.version == gridVersion
+        && header.byteOrder == gridByteOrder
+        && header.rows > 0 && header.cols > 0
+        && header.rows < 0x10000000u && header.cols < 0x10000000u
+        && header.cellOffset >= sizeof(GridFileHeader);
+    if (valid) {
+        uint64_t cellBytes = static_cast<uint64_t>(header.rows + 2) * (header.cols + 2);
+        valid = cellBytes <= 0x7fffffffu && header.cellOffset + cellBytes <= mappedBytes;
+    }
+    if (valid) {
+        grid.cells = static_cast<const uint8_t*>(mapping) + header.cellOffset;
+        grid.rows = static_cast<int>(header.rows);
+        grid.cols = static_cast<int>(header.cols);
+        grid.stride = grid.cols + 2;
+        valid = hasWallBorder(grid);
+    }
+    if (!valid) {
+        close();
+        throw std::runtime_error("Invalid grid file: " + path);
+    }
+}
+
+GridFile::~GridFile() {
+    close();
+}
+
+GridFile::GridFile(GridFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+GridFile& GridFile::operator=(GridFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        mapping = std::exchange(other.mapping, nullptr);
+        mappedBytes = std::exchange(other.mappedBytes, 0);
+#ifdef _WIN32
+        fileHandle = std::exchange(other.fileHandle, nullptr);
+        mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+        grid = std::exchange(other.grid, GridView());
+    }
+    return *this;
+}
+
+void GridFile::close() {
+#ifdef _WIN32
+    if (mapping != nullptr) {
+        UnmapViewOfFile(mapping);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != nullptr) {
+        CloseHandle(fileHandle);
+    }
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    if (mapping != nullptr) {
+        munmap(const_cast<void*>(mapping), mappedBytes);
+    }
+#endif
+    mapping = nullptr;
+    mappedBytes = 0;
+    grid = GridView();
+}
+
+void GridFile::save(const std::string& path, const GridView& grid) {
+    if (grid.empty()) {
+        throw std::runtime_error("Cannot save an empty grid: " + path);
+    }
+
+    GridFileHeader header = {};
+    std::memcpy(header.magic, gridMagic, sizeof(gridMagic));
+    header.version = gridVersion;
+    header.byteOrder = gridByteOrder;
+    header.rows = static_cast<uint32_t>(grid.rows);
+    header.cols = static_cast<uint32_t>(grid.cols);
+    header.cellOffset = sizeof(GridFileHeader);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(grid.cells), grid.cellCount());
+    if (!out) {
+        throw std::runtime_error("Cannot write grid file: " + path);
+    }
+}
+
+bool GridFile::isGridFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(gridMagic)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, gridMagic, sizeof(gridMagic)) == 0;
+}
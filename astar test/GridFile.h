@@ -0,0 +1,56 @@
+#ifndef GRIDFILE_H
+#define GRIDFILE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "GridStorage.h"
+
+// Compact binary map: a 32-byte header followed by the padded cell buffer
+// exactly as GridView reads it, one byte per cell with the wall border
+// included. Opening one maps the file read-only instead of parsing it, so
+// startup does not depend on the map size, searches read the file pages
+// directly, and processes opening the same map share those pages.
+//
+// Header (little-endian):
+//   char     magic[8]      "ASTGRID\n"
+//   uint32_t version       1
+//   uint32_t byteOrder     0x01020304, as written by the saving machine
+//   uint32_t rows, cols
+//   uint32_t cellOffset    where the cells start, 32
+//   uint32_t reserved      0
+class GridFile {
+public:
+    GridFile() = default;
+    // Maps path read-only. Throws std::runtime_error if it cannot be opened or
+    // is not a valid grid file.
+    explicit GridFile(const std::string& path);
+    ~GridFile();
+
+    GridFile(GridFile&& other) noexcept;
+    GridFile& operator=(GridFile&& other) noexcept;
+    GridFile(const GridFile&) = delete;
+    GridFile& operator=(const GridFile&) = delete;
+
+    // Valid as long as this GridFile is open.
+    GridView view() const { return grid; }
+    bool isOpen() const { return mapping != nullptr; }
+
+    // Writes grid in the format above. Throws std::runtime_error on failure.
+    static void save(const std::string& path, const GridView& grid);
+    // True if path starts with the grid file magic.
+    static bool isGridFile(const std::string& path);
+
+private:
+    const void* mapping = nullptr;
+    size_t mappedBytes = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+    GridView grid;
+
+    void close();
+};
+
+#endif  // GRIDFILE_H
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include "GridRenderer.h"
+
+namespace {
+    // never a 0x00RRGGBB color, so a cell "shown" in it is always repainted
+    constexpr uint32_t notPainted = 0xffffffffu;
+}
+
+FrameBuffer::FrameBuffer(int width, int height, uint32_t fill)
+    : w(std::max(width, 0)), h(std::max(height, 0)), pixels(static_cast<size_t>(w) * h, fill) {}
+
+void FrameBuffer::fill(const PixelRect& rect, uint32_t color) {
+    int left = std::max(rect.left, 0);
+    int right = std::min(rect.right, w);
+    int top = std::max(rect.top, 0);
+    int bottom = std::min(rect.bottom, h);
+    if (left >= right) {
+        return;
+    }
+    for (int y = top; y < bottom; ++y) {
+        uint32_t* row = pixels.data() + static_cast<size_t>(y) * w;
+        std::fill(row + left, row + right, color);
+    }
+}
+
+void FrameBuffer::savePPM(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "P6\n" << w << " " << h << "\n255\n";
+
+    std::vector<char> line(static_cast<size_t>(w) * 3);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            uint32_t color = pixel(x, y);
+            line[x * 3] = static_cast<char>(color >> 16);
+            line[x * 3 + 1] = static_cast<char>(color >> 8);
+            line[x * 3 + 2] = static_cast<char>(color);
+        }
+        out.write(line.data(), line.size());
+    }
+    if (!out) {
+        throw std::runtime_error("Cannot write PPM file: " + path);
+    }
+}
+
+GridRenderer::GridRenderer(int rows, int cols, int size, int spacing, const Palette& palette)
+    : rows(rows), cols(cols), size(size), spacing(spacing), palette(palette),
+      image(cols * (size + spacing), rows * (size + spacing), palette.background),
+      overlay(static_cast<size_t>(rows) * cols, 0),
+      shown(static_cast<size_t>(rows) * cols, notPainted),
+      is_dirty(static_cast<size_t>(rows) * cols, false) {
+    invalidateAll();
+}
+
+PixelRect GridRenderer::cellRect(int row, int col) const {
+    PixelRect rect;
+    rect.left = col * (size + spacing);
+    rect.top = row * (size + spacing);
+    rect.right = rect.left + size;
+    rect.bottom = rect.top + size;
+    return rect;
+}
+
+void GridRenderer::markDirty(int cell) {
+    if (!is_dirty[cell]) {
+        is_dirty[cell] = true;
+        dirty.push_back(cell);
+    }
+}
+
+void GridRenderer::cellChanged(int row, int col) {
+    if (row < 0 || row >= rows || col < 0 || col >= cols) {
+        throw std::out_of_range("Invalid cell position");
+    }
+    markDirty(row * cols + col);
+}
+
+void GridRenderer::setOverlay(std::vector<Point>& current, const std::vector<Point>& cells, uint8_t bit) {
+    if (cells == current) {
+        return;  // the common case while nothing is edited
+    }
+    for (const Point& p : cells) {
+        if (p.x < 0 || p.x >= rows || p.y < 0 || p.y >= cols) {
+            throw std::out_of_range("Invalid cell position");
+        }
+    }
+
+    // cells on both lists are marked twice but repainted at most once, and
+    // only if their color actually changed
+    for (const Point& p : current) {
+        overlay[p.x * cols + p.y] &= ~bit;
+        markDirty(p.x * cols + p.y);
+    }
+    current = cells;
+    for (const Point& p : current) {
+        overlay[p.x * cols + p.y] |= bit;
+        markDirty(p.x * cols + p.y);
+    }
+}
+
+void GridRenderer::setPath(const std::vector<Point>& cells) {
+    setOverlay(path, cells, overlayPath);
+}
+
+void GridRenderer::setExplored(const std::vector<Point>& cells) {
+    setOverlay(explored, cells, overlayExplored);
+}
+
+void GridRenderer::invalidateAll() {
+    std::fill(shown.begin(), shown.end(), notPainted);
+    for (int cell = 0; cell < rows * cols; ++cell) {
+        markDirty(cell);
+    }
+}
+
+uint32_t GridRenderer::colorOf(const GridView& grid, int cell) const {
+    uint8_t value = grid.at(Point(cell / cols, cell % cols));
+    if (value != CELL_WALL) {
+        if (overlay[cell] & overlayPath) {
+            return palette.path;
+        }
+        if (overlay[cell] & overlayExplored) {
+            return palette.explored;
+        }
+    }
+    return value < palette.cells.size() ? palette.cells[value] : palette.background;
+}
+
+const std::vector<PixelRect>& GridRenderer::render(const GridView& grid) {
+    if (grid.rows != rows || grid.cols != cols) {
+        throw std::invalid_argument("Grid size differs from the renderer's");
+    }
+
+    damage.clear();
+    repainted = 0;
+
+    // in row order, so neighbors in a row merge into one rectangle
+    std::sort(dirty.begin(), dirty.end());
+    for (int cell : dirty) {
+        is_dirty[cell] = false;
+        uint32_t color = colorOf(grid, cell);
+        if (color == shown[cell]) {
+            continue;
+        }
+        shown[cell] = color;
+
+        PixelRect rect = cellRect(cell / cols, cell % cols);
+        image.fill(rect, color);
+        ++repainted;
+
+        // the spacing in between is background either way
+        if (!damage.empty() && damage.back().top == rect.top && damage.back().right + spacing == rect.left) {
+            damage.back().right = rect.right;
+        }
+        else {
+            damage.push_back(rect);
+        }
+    }
+    dirty.clear();
+
+    if (damage.size() > maxDamageRects) {
+        PixelRect bounds = damage.front();
+        for (const PixelRect& rect : damage) {
+            bounds.left = std::min(bounds.left, rect.left);
+            bounds.right = std::max(bounds.right, rect.right);
+            bounds.bottom = std::max(bounds.bottom, rect.bottom);
+        }
+        damage.assign(1, bounds);
+    }
+    return damage;
+}
@@ -0,0 +1,113 @@
+#ifndef GRIDRENDERER_H
+#define GRIDRENDERER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Point.h"
+#include "GridStorage.h"
+
+// 0x00RRGGBB, the pixel layout of a 32-bit top-down DIB, so the Win32 front
+// end can hand the buffer to GDI as it is.
+constexpr uint32_t rgbColor(uint8_t r, uint8_t g, uint8_t b) {
+    return (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | b;
+}
+
+// Pixel rectangle, right and bottom exclusive.
+struct PixelRect {
+    int left = 0;
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+
+    bool empty() const { return left >= right || top >= bottom; }
+};
+
+// In-memory image, rows of width pixels from the top.
+class FrameBuffer {
+public:
+    FrameBuffer(int width = 0, int height = 0, uint32_t fill = 0);
+
+    int width() const { return w; }
+    int height() const { return h; }
+    const uint32_t* data() const { return pixels.data(); }
+    uint32_t pixel(int x, int y) const { return pixels[static_cast<size_t>(y) * w + x]; }
+
+    // Clipped to the image.
+    void fill(const PixelRect& rect, uint32_t color);
+    // Binary PPM (P6), for looking at frames without a window.
+    void savePPM(const std::string& path) const;
+
+private:
+    int w;
+    int h;
+    std::vector<uint32_t> pixels;
+};
+
+// Draws a grid as squares of size pixels with spacing between them into a
+// FrameBuffer, and only repaints cells reported as changed: edits through
+// cellChanged, path and explored overlays through setPath/setExplored. Each
+// render() returns the pixel rectangles that changed, so a front end copies
+// just those to the screen and a frame costs O(changed cells), not O(grid).
+class GridRenderer {
+public:
+    // Colors for the grid's cell values; values without one get the background.
+    struct Palette {
+        uint32_t background = rgbColor(255, 255, 255);  // spacing and unlisted values
+        uint32_t explored = rgbColor(92, 88, 128);
+        uint32_t path = rgbColor(71, 247, 75);
+        std::vector<uint32_t> cells;  // by cell value
+    };
+
+    // More damage than this is reported as its bounding box, which is one
+    // copy instead of thousands of small ones.
+    static constexpr size_t maxDamageRects = 256;
+
+    GridRenderer(int rows, int cols, int size, int spacing, const Palette& palette);
+
+    // Marks a cell whose value changed.
+    void cellChanged(int row, int col);
+    // Overlays, drawn over passable cells only; the path over explored cells.
+    void setPath(const std::vector<Point>& cells);
+    void setExplored(const std::vector<Point>& cells);
+    // Repaints every cell on the next render, e.g. after a palette change.
+    void invalidateAll();
+
+    // Repaints the changed cells of grid, which must be as large as the
+    // renderer, and returns the pixels that changed since the last call.
+    const std::vector<PixelRect>& render(const GridView& grid);
+
+    const FrameBuffer& frame() const { return image; }
+    // Cells repainted by the last render.
+    size_t lastRepainted() const { return repainted; }
+    // Where a cell is drawn.
+    PixelRect cellRect(int row, int col) const;
+
+private:
+    enum : uint8_t {
+        overlayExplored = 1,
+        overlayPath = 2,
+    };
+
+    int rows;
+    int cols;
+    int size;
+    int spacing;
+    Palette palette;
+    FrameBuffer image;
+
+    std::vector<uint8_t> overlay;  // per cell (row * cols + col)
+    std::vector<uint32_t> shown;   // color each cell was last painted in
+    std::vector<int> dirty;        // cells (row * cols + col) to look at next render
+    std::vector<bool> is_dirty;
+    std::vector<Point> path;
+    std::vector<Point> explored;
+    std::vector<PixelRect> damage;
+    size_t repainted = 0;
+
+    void markDirty(int cell);
+    void setOverlay(std::vector<Point>& current, const std::vector<Point>& cells, uint8_t bit);
+    uint32_t colorOf(const GridView& grid, int cell) const;
+};
+
+#endif  // GRIDRENDERER_H
@@ -0,0 +1,91 @@
+#ifndef GRIDSTORAGE_H
+#define GRIDSTORAGE_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "Point.h"
+
+constexpr uint8_t CELL_WALL = 1;
+
+// Cells from CELL_TERRAIN up are passable terrain (mud, ramps) that costs
+// cell - CELL_TERRAIN + 1 to enter. Every other passable value costs 1, so the
+// app's start, finish and path markers below CELL_TERRAIN keep working.
+constexpr uint8_t CELL_TERRAIN = 16;
+constexpr int CELL_MAX_COST = 256 - CELL_TERRAIN;
+
+// Cell value for terrain with the given entry cost, 1..CELL_MAX_COST.
+constexpr uint8_t terrainCell(int cost) { return static_cast<uint8_t>(CELL_TERRAIN + cost - 1); }
+// Entry cost of a passable cell value.
+constexpr int cellCost(uint8_t cell) { return cell < CELL_TERRAIN ? 1 : cell - CELL_TERRAIN + 1; }
+
+// Read-only window onto a padded cell buffer: rows x cols cells surrounded by a
+// one-cell wall border, so neighbor indices (index +- 1, index +- stride) never
+// need a bounds check. Cheap to copy; the buffer must outlive the view.
+struct GridView {
+    const uint8_t* cells = nullptr;
+    int rows = 0;
+    int cols = 0;
+    int stride = 0;  // cols + 2
+
+    bool empty() const { return rows == 0 || cols == 0; }
+    bool contains(const Point& p) const { return p.x >= 0 && p.x < rows && p.y >= 0 && p.y < cols; }
+
+    // Size of the padded buffer; search state is indexed the same way.
+    int cellCount() const { return (rows + 2) * stride; }
+    int index(const Point& p) const { return (p.x + 1) * stride + p.y + 1; }
+    Point point(int index) const { return Point(index / stride - 1, index % stride - 1); }
+
+    uint8_t at(int index) const { return cells[index]; }
+    uint8_t at(const Point& p) const { return cells[index(p)]; }
+    bool isWall(int index) const { return cells[index] == CELL_WALL; }
+    // Cost of stepping onto a passable cell.
+    int cost(int index) const { return cellCost(cells[index]); }
+};
+
+// One contiguous byte per cell plus the wall border that GridView relies on.
+class GridStorage {
+public:
+    GridStorage(int nRows = 0, int nCols = 0, uint8_t fill = 0)
+        : rows(nRows), cols(nCols), cells(static_cast<size_t>(nRows + 2) * (nCols + 2), CELL_WALL) {
+        // whole interior rows: GCC's -Warray-bounds cannot follow a per-cell
+        // subscript on a 0 x 0 grid and warns about the border
+        for (int row = 0; row < rows; ++row) {
+            std::fill_n(cells.begin() + offset(row, 0), cols, fill);
+        }
+    }
+
+    explicit GridStorage(const std::vector<std::vector<int>>& grid)
+        : GridStorage(static_cast<int>(grid.size()), grid.empty() ? 0 : static_cast<int>(grid[0].size())) {
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                cells[offset(row, col)] = static_cast<uint8_t>(grid[row][col]);
+            }
+        }
+    }
+
+    // Editable copy of any view, e.g. a mapped GridFile.
+    explicit GridStorage(const GridView& view)
+        : rows(view.rows), cols(view.cols), cells(static_cast<size_t>(view.rows + 2) * (view.cols + 2), CELL_WALL) {
+        if (view.cells != nullptr) {
+            std::copy(view.cells, view.cells + cells.size(), cells.begin());
+        }
+    }
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+
+    uint8_t get(int row, int col) const { return cells[offset(row, col)]; }
+    void set(int row, int col, uint8_t value) { cells[offset(row, col)] = value; }
+
+    GridView view() const { return GridView{ cells.data(), rows, cols, cols + 2 }; }
+
+private:
+    int rows;
+    int cols;
+    std::vector<uint8_t> cells;
+
+    size_t offset(int row, int col) const { return static_cast<size_t>(row + 1) * (cols + 2) + col + 1; }
+};
+
+#endif  // GRIDSTORAGE_H
@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <cstdlib>
+#include "HPAStar.h"
+
+namespace {
+    constexpr int offsets[4][2] = { {0, 1}, {0, -1}, {1, 0}, {-1, 0} };  // right, left, down, up
+
+    // runs at least this long get an entrance at both ends instead of the middle
+    constexpr int longEntrance = 6;
+}
+
+HPAStar::HPAStar(int clusterSize) : cluster_size(clusterSize > 1 ? clusterSize : 2) {
+}
+
+bool HPAStar::isFree(const GridView& grid, int row, int col) const {
+    // one cell outside the grid still lands on the wall border
+    return !grid.isWall(grid.index(Point(row, col)));
+}
+
+void HPAStar::build(const GridView& grid) {
+    rows = grid.rows;
+    cols = grid.cols;
+    cluster_rows = (rows + cluster_size - 1) / cluster_size;
+    cluster_cols = (cols + cluster_size - 1) / cluster_size;
+
+    clusters.assign(cluster_rows * cluster_cols, Cluster());
+    for (int cr = 0; cr < cluster_rows; ++cr) {
+        for (int cc = 0; cc < cluster_cols; ++cc) {
+            Cluster& cluster = clusters[cr * cluster_cols + cc];
+            cluster.top = cr * cluster_size;
+            cluster.left = cc * cluster_size;
+            cluster.height = std::min(cluster_size, rows - cluster.top);
+            cluster.width = std::min(cluster_size, cols - cluster.left);
+        }
+    }
+
+    built = true;
+    update(grid);
+}
+
+void HPAStar::cellChanged(int row, int col) {
+    if (!built || row < 0 || row >= rows || col < 0 || col >= cols) {
+        return;
+    }
+
+    // border cells also feed the entrances of the cluster across the border
+    clusters[clusterOf(row, col)].dirty = true;
+    if (row % cluster_size == 0 && row > 0) {
+        clusters[clusterOf(row - 1, col)].dirty = true;
+    }
+    if (row % cluster_size == cluster_size - 1 && row + 1 < rows) {
+        clusters[clusterOf(row + 1, col)].dirty = true;
+    }
+    if (col % cluster_size == 0 && col > 0) {
+        clusters[clusterOf(row, col - 1)].dirty = true;
+    }
+    if (col % cluster_size == cluster_size - 1 && col + 1 < cols) {
+        clusters[clusterOf(row, col + 1)].dirty = true;
+    }
+}
+
+void HPAStar::addEntrances(const GridView& grid, Cluster& cluster, int row, int col, int dRow, int dCol, int length, int outRow, int outCol) {
+    auto add = [&](int step) {
+        int r = row + step * dRow;
+        int c = col + step * dCol;
+        cluster.cells.push_back(r * cols + c);
+        cluster.partners.push_back((r + outRow) * cols + c + outCol);
+    };
+
+    int runStart = -1;
+    for (int step = 0; step <= length; ++step) {
+        int r = row + step * dRow;
+        int c = col + step * dCol;
+        bool open = step < length && isFree(grid, r, c) && isFree(grid, r + outRow, c + outCol);
+
+        if (open && runStart == -1) {
+            runStart = step;
+        }
+        else if (!open && runStart != -1) {
+            int runLength = step - runStart;
+            if (runLength < longEntrance) {
+                add(runStart + runLength / 2);
+            }
+            else {
+                add(runStart);
+                add(step - 1);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+void HPAStar::rebuildCluster(const GridView& grid, int index) {
+    Cluster& cluster = clusters[index];
+    cluster.cells.clear();
+    cluster.partners.clear();
+
+    int bottom = cluster.top + cluster.height - 1;
+    int right = cluster.left + cluster.width - 1;
+    if (cluster.top > 0) {
+        addEntrances(grid, cluster, cluster.top, cluster.left, 0, 1, cluster.width, -1, 0);
+    }
+    if (bottom + 1 < rows) {
+        addEntrances(grid, cluster, bottom, cluster.left, 0, 1, cluster.width, 1, 0);
+    }
+    if (cluster.left > 0) {
+        addEntrances(grid, cluster, cluster.top, cluster.left, 1, 0, cluster.height, 0, -1);
+    }
+    if (right + 1 < cols) {
+        addEntrances(grid, cluster, cluster.top, right, 1, 0, cluster.height, 0, 1);
+    }
+
+    int count = cluster.cells.size();
+    cluster.distances.assign(count * count, infinity);
+    for (int i = 0; i < count; ++i) {
+        clusterDistances(grid, cluster, cluster.cells[i]);
+        for (int j = 0; j < count; ++j) {
+            cluster.distances[i * count + j] = localDistance(cluster, cluster.cells[j]);
+        }
+    }
+
+    stride = std::max(stride, count);
+    cluster.dirty = false;
+    ++rebuilds;
+}
+
+void HPAStar::update(const GridView& grid) {
+    for (int i = 0; i < static_cast<int>(clusters.size()); ++i) {
+        if (clusters[i].dirty) {
+            rebuildCluster(grid, i);
+        }
+    }
+}
+
+void HPAStar::clusterDistances(const GridView& grid, const Cluster& cluster, int fromCell) {
+    // breadth-first search that never leaves the cluster
+    bfs_distance.assign(cluster.height * cluster.width, infinity);
+    bfs_queue.clear();
+
+    int source = (fromCell / cols - cluster.top) * cluster.width + (fromCell % cols - cluster.left);
+    bfs_distance[source] = 0;
+    bfs_queue.push_back(source);
+
+    for (size_t head = 0; head < bfs_queue.size(); ++head) {
+        int local = bfs_queue[head];
+        int r = local / cluster.width;
+        int c = local % cluster.width;
+
+        for (const auto& offset : offsets) {
+            int nr = r + offset[0];
+            int nc = c + offset[1];
+            if (nr < 0 || nr >= cluster.height || nc < 0 || nc >= cluster.width) {
+                continue;
+            }
+
+            int next = nr * cluster.width + nc;
+            if (bfs_distance[next] == infinity && isFree(grid, cluster.top + nr, cluster.left + nc)) {
+                bfs_distance[next] = bfs_distance[local] + 1;
+                bfs_queue.push_back(next);
+            }
+        }
+    }
+}
+
+int HPAStar::localDistance(const Cluster& cluster, int cell) const {
+    return bfs_distance[(cell / cols - cluster.top) * cluster.width + (cell % cols - cluster.left)];
+}
+
+int HPAStar::entranceIndex(const Cluster& cluster, int cell, int partner) const {
+    for (int i = 0; i < static_cast<int>(cluster.cells.size()); ++i) {
+        if (cluster.cells[i] == cell && cluster.partners[i] == partner) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::vector<Point> HPAStar::findAbstractPath(const GridView& grid, const Point& start, const Point& goal) {
+    if (!built || rows != grid.rows || cols != grid.cols) {
+        build(grid);
+    }
+    else {
+        update(grid);
+    }
+
+    auto inside = [this](const Point& p) { return p.x >= 0 && p.x < rows && p.y >= 0 && p.y < cols; };
+    if (!inside(start) || !inside(goal) || !isFree(grid, start.x, start.y)) {
+        return {};
+    }
+
+    int startCell = start.x * cols + start.y;
+    int goalCell = goal.x * cols + goal.y;
+    int startCluster = clusterOf(start.x, start.y);
+    int goalCluster = clusterOf(goal.x, goal.y);
+
+    // temporary links from start and goal into their clusters
+    const Cluster& fromCluster = clusters[startCluster];
+    const Cluster& toCluster = clusters[goalCluster];
+    clusterDistances(grid, fromCluster, startCell);
+    std::vector<int> startLinks;
+    for (int cell : fromCluster.cells) {
+        startLinks.push_back(localDistance(fromCluster, cell));
+    }
+    int direct = startCluster == goalCluster && isFree(grid, goal.x, goal.y) ? localDistance(fromCluster, goalCell) : infinity;
+
+    clusterDistances(grid, toCluster, goalCell);
+    std::vector<int> goalLinks;
+    for (int cell : toCluster.cells) {
+        goalLinks.push_back(isFree(grid, goal.x, goal.y) ? localDistance(toCluster, cell) : infinity);
+    }
+
+    int nodeCount = static_cast<int>(clusters.size()) * stride + 2;
+    int startNode = nodeCount - 2;
+    int goalNode = nodeCount - 1;
+    auto cellOf = [&](int node) {
+        if (node == startNode) {
+            return startCell;
+        }
+        if (node == goalNode) {
+            return goalCell;
+        }
+        return clusters[node / stride].cells[node % stride];
+    };
+    auto heuristic = [&](int cell) { return abs(cell / cols - goal.x) + abs(cell % cols - goal.y); };
+
+    openSet.resize(nodeCount);
+    state.reset(nodeCount);
+    state.open(startNode, 0, SearchState::noParent);
+    openSet.push(startNode, { heuristic(startCell), heuristic(startCell) });
+
+    auto relax = [&](int from, int to, int cost) {
+        if (cost >= infinity || state.status(to) == SearchState::Closed) {
+            return;
+        }
+        int g = state.g(from) + cost;
+        if (g >= state.g(to)) {
+            return;
+        }
+        int h = heuristic(cellOf(to));
+        state.open(to, g, from);
+        openSet.pushOrDecrease(to, { g + h, h });
+    };
+
+    while (!openSet.empty()) {
+        int current = openSet.pop();
+        if (current == goalNode) {
+            std::vector<Point> waypoints;
+            for (int node = current; node != SearchState::noParent; node = state.parent(node)) {
+                int cell = cellOf(node);
+                Point point(cell / cols, cell % cols);
+                if (waypoints.empty() || !(waypoints.back() == point)) {
+                    waypoints.push_back(point);
+                }
+            }
+            std::reverse(waypoints.begin(), waypoints.end());
+            return waypoints;
+        }
+
+        state.close(current);
+
+        if (current == startNode) {
+            for (int i = 0; i < static_cast<int>(startLinks.size()); ++i) {
+                relax(current, startCluster * stride + i, startLinks[i]);
+            }
+            relax(current, goalNode, direct);
+            continue;
+        }
+
+        int clusterIndex = current / stride;
+        int entrance = current % stride;
+        const Cluster& cluster = clusters[clusterIndex];
+        int count = cluster.cells.size();
+
+        for (int j = 0; j < count; ++j) {
+            if (j != entrance) {
+                relax(current, clusterIndex * stride + j, cluster.distances[entrance * count + j]);
+            }
+        }
+
+        int partner = cluster.partners[entrance];
+        int partnerCluster = clusterOf(partner / cols, partner % cols);
+        int partnerEntrance = entranceIndex(clusters[partnerCluster], partner, cluster.cells[entrance]);
+        if (partnerEntrance != -1) {
+            relax(current, partnerCluster * stride + partnerEntrance, 1);
+        }
+
+        if (clusterIndex == goalCluster) {
+            relax(current, goalNode, goalLinks[entrance]);
+        }
+    }
+
+    return {};  // no path found
+}
+
+bool HPAStar::refineSegment(const GridView& grid, const Point& from, const Point& to, std::vector<Point>& path) {
+    if (abs(from.x - to.x) + abs(from.y - to.y) <= 1) {
+        path.push_back(to);
+        return true;
+    }
+
+    // both ends lie in one cluster: walk down the distance field of the target
+    const Cluster& cluster = clusters[clusterOf(from.x, from.y)];
+    clusterDistances(grid, cluster, to.x * cols + to.y);
+
+    Point current = from;
+    while (!(current == to)) {
+        int distance = localDistance(cluster, current.x * cols + current.y);
+        bool stepped = false;
+        for (const auto& offset : offsets) {
+            Point next(current.x + offset[0], current.y + offset[1]);
+            if (next.x >= cluster.top && next.x < cluster.top + cluster.height
+                && next.y >= cluster.left && next.y < cluster.left + cluster.width
+                && localDistance(cluster, next.x * cols + next.y) == distance - 1) {
+                current = next;
+                stepped = true;
+                break;
+            }
+        }
+
+        if (!stepped) {
+            return false;  // to is not reachable inside the cluster
+        }
+        path.push_back(current);
+    }
+    return true;
+}
+
+std::vector<Point> HPAStar::findPath(const GridView& grid, const Point& start, const Point& goal) {
+    std::vector<Point> waypoints = findAbstractPath(grid, start, goal);
+    if (waypoints.empty()) {
+        return {};
+    }
+
+    std::vector<Point> path = { waypoints[0] };
+    for (size_t i = 1; i < waypoints.size(); ++i) {
+        if (!refineSegment(grid, waypoints[i - 1], waypoints[i], path)) {
+            return {};
+        }
+    }
+
+    return path;
+}
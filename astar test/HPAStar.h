@@ -0,0 +1,84 @@
+#ifndef HPASTAR_H
+#define HPASTAR_H
+
+#include <vector>
+#include "AStar.h"
+#include "OpenList.h"
+#include "SearchState.h"
+
+// Hierarchical path-finding A* (HPA*). The grid is cut into square clusters;
+// every free run along a cluster border gets one or two entrance cells, and the
+// walking distances between the entrances of a cluster are precomputed. Long
+// queries are answered on that small abstract graph and only then refined into
+// cells, one cluster at a time. Paths are near-optimal, not always optimal,
+// and every passable cell costs 1 (terrain costs are ignored).
+class HPAStar {
+public:
+    explicit HPAStar(int clusterSize = 16);
+
+    // Full rebuild of the abstract graph.
+    void build(const GridView& grid);
+
+    // Marks the clusters whose entrances or distances depend on this cell; they
+    // are rebuilt on the next query instead of the whole graph.
+    void cellChanged(int row, int col);
+
+    // Rebuilds the clusters marked by cellChanged; queries do this on their own.
+    void update(const GridView& grid);
+
+    bool isBuilt() const { return built; }
+
+    // Entrance cells to walk through, start and goal included. Consecutive
+    // points either share a cluster or are neighbors across a border.
+    std::vector<Point> findAbstractPath(const GridView& grid, const Point& start, const Point& goal);
+
+    // Appends the cells after from up to and including to (one abstract step).
+    // False if to cannot be reached from within the cluster; path is then partial.
+    bool refineSegment(const GridView& grid, const Point& from, const Point& to, std::vector<Point>& path);
+
+    // Abstract search plus refinement of every segment.
+    std::vector<Point> findPath(const GridView& grid, const Point& start, const Point& goal);
+
+    int clusterCount() const { return static_cast<int>(clusters.size()); }
+    long long clusterRebuilds() const { return rebuilds; }
+
+private:
+    struct Cluster {
+        int top = 0;
+        int left = 0;
+        int height = 0;
+        int width = 0;
+        bool dirty = true;
+        std::vector<int> cells;     // entrance cells inside this cluster
+        std::vector<int> partners;  // matching cell across the border
+        std::vector<int> distances; // cells.size() squared walking distances inside the cluster
+    };
+
+    static constexpr int infinity = 0x3fffffff;
+
+    int cluster_size;
+    int rows = 0;
+    int cols = 0;
+    int cluster_rows = 0;
+    int cluster_cols = 0;
+    bool built = false;
+    long long rebuilds = 0;
+    std::vector<Cluster> clusters;
+
+    // abstract search scratch; node id = cluster * stride + entrance, then start and goal
+    int stride = 1;
+    IndexedHeap<NodeKey> openSet;
+    SearchState state;
+    std::vector<int> bfs_distance;
+    std::vector<int> bfs_queue;
+
+    int clusterOf(int row, int col) const { return (row / cluster_size) * cluster_cols + col / cluster_size; }
+    bool isFree(const GridView& grid, int row, int col) const;
+    void addEntrances(const GridView& grid, Cluster& cluster, int row, int col, int dRow, int dCol, int length, int outRow, int outCol);
+    void rebuildCluster(const GridView& grid, int index);
+    void clusterDistances(const GridView& grid, const Cluster& cluster, int fromCell);
+    int localDistance(const Cluster& cluster, int cell) const;
+    int entranceIndex(const Cluster& cluster, int cell, int partner) const;
+};
+
+#endif  // HPASTAR_H
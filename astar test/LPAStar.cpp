@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cstdlib>
+#include "LPAStar.h"
+
+bool LPAStar::isPassable(const GridView& grid, int index) const {
+    // the start is a source even when it is painted over
+    return !grid.isWall(index) || index == startIndex;
+}
+
+LPAStar::Key LPAStar::calculateKey(int index) const {
+    int x = index / stride;
+    int y = index % stride;
+    int best = std::min(g[index], rhs[index]);
+    return { best + abs(x - goalIndex / stride) + abs(y - goalIndex % stride), best };
+}
+
+void LPAStar::initialize(const GridView& grid, const Point& newStart, const Point& newGoal) {
+    rows = grid.rows;
+    cols = grid.cols;
+    stride = grid.stride;
+    start = newStart;
+    goal = newGoal;
+    startIndex = grid.index(start);
+    goalIndex = grid.index(goal);
+
+    g.assign(grid.cellCount(), infinity);
+    rhs.assign(grid.cellCount(), infinity);
+    openSet.resize(grid.cellCount());
+
+    rhs[startIndex] = 0;
+    openSet.push(startIndex, calculateKey(startIndex));
+    recorder.pushed(openSet.size());
+    initialized = true;
+}
+
+void LPAStar::updateVertex(const GridView& grid, int index) {
+    if (index != startIndex) {
+        int best = infinity;
+        if (isPassable(grid, index)) {
+            // the wall border keeps every neighbor inside the buffer
+            for (int offset : { 1, -1, stride, -stride }) {
+                if (isPassable(grid, index + offset)) {
+                    best = std::min(best, g[index + offset] + grid.cost(index));
+                }
+            }
+        }
+        rhs[index] = std::min(best, infinity);
+    }
+
+    if (g[index] != rhs[index]) {
+        if (openSet.contains(index)) {
+            openSet.update(index, calculateKey(index));
+        }
+        else {
+            openSet.push(index, calculateKey(index));
+        }
+        recorder.pushed(openSet.size());
+    }
+    else if (openSet.contains(index)) {
+        openSet.remove(index);
+    }
+}
+
+void LPAStar::computeShortestPath(const GridView& grid) {
+    while (!openSet.empty() && (openSet.topKey() < calculateKey(goalIndex) || rhs[goalIndex] != g[goalIndex])) {
+        int current = openSet.pop();
+        recorder.expanded(grid, current);
+
+        if (g[current] > rhs[current]) {
+            g[current] = rhs[current];  // overconsistent: settle it
+        }
+        else {
+            recorder.reopened();
+            g[current] = infinity;  // underconsistent: a cost went up, re-derive from neighbors
+            updateVertex(grid, current);
+        }
+
+        for (int offset : { 1, -1, stride, -stride }) {
+            if (!grid.isWall(current + offset) || current + offset == startIndex) {
+                updateVertex(grid, current + offset);
+            }
+        }
+    }
+}
+
+void LPAStar::extractPath(const GridView& grid) {
+    path.clear();
+
+    int current = goalIndex;
+    if (g[current] >= infinity) {
+        return;  // no path found
+    }
+
+    // walk back to the neighbor each cell got its g from
+    path.push_back(goal);
+    while (g[current] > 0) {
+        int next = -1;
+        for (int offset : { 1, -1, stride, -stride }) {
+            if (isPassable(grid, current + offset) && g[current + offset] == g[current] - grid.cost(current)) {
+                next = current + offset;
+                break;
+            }
+        }
+
+        if (next == -1) {
+            path.clear();
+            return;
+        }
+
+        current = next;
+        path.push_back(grid.point(current));
+    }
+
+    std::reverse(path.begin(), path.end());
+}
+
+const std::pmr::vector<Point>& LPAStar::findPath(const GridView& grid, const Point& newStart, const Point& newGoal, const std::vector<Point>& changedCells) {
+    recorder.begin();
+    if (!grid.contains(newStart) || !grid.contains(newGoal)) {
+        path.clear();
+        recorder.end();
+        return path;
+    }
+
+    bool sameProblem = initialized
+        && rows == grid.rows && cols == grid.cols
+        && start == newStart && goal == newGoal;
+
+    if (!sameProblem) {
+        initialize(grid, newStart, newGoal);
+    }
+    else {
+        // a changed cell alters its own incoming edges and those of its neighbors
+        for (const Point& cell : changedCells) {
+            int index = grid.index(cell);
+            updateVertex(grid, index);
+            for (int offset : { 1, -1, stride, -stride }) {
+                updateVertex(grid, index + offset);
+            }
+        }
+    }
+
+    computeShortestPath(grid);
+    extractPath(grid);
+    recorder.end();
+    return path;
+}
@@ -0,0 +1,65 @@
+#ifndef LPASTAR_H
+#define LPASTAR_H
+
+#include <vector>
+#include <memory_resource>
+#include "AStar.h"
+#include "OpenList.h"
+#include "SearchStats.h"
+
+// Lifelong Planning A*: keeps g/rhs values and the open list between queries,
+// so after a few cells change only the part of the search tree that depends on
+// them is repaired instead of searching the whole grid again.
+// Honors terrain costs (CELL_TERRAIN).
+class LPAStar {
+public:
+    // Replans for the cells that changed since the previous call. A different
+    // start, goal or grid size (or a call after invalidate()) starts over.
+    const std::pmr::vector<Point>& findPath(const GridView& grid, const Point& start, const Point& goal, const std::vector<Point>& changedCells);
+
+    // Drops the search tree; the next findPath searches from scratch.
+    void invalidate() { initialized = false; }
+
+    // Work done by the last findPath call; a repair after a few edits expands
+    // far fewer cells than the first search. Cells whose cost went up count as
+    // reopenings.
+    const SearchStats& lastStats() const { return recorder.stats(); }
+    // Reports every expanded cell of the following calls; nullptr to stop.
+    void setTrace(SearchTrace callback, void* user = nullptr) { recorder.setTrace(callback, user); }
+
+private:
+    struct Key {
+        int k1;
+        int k2;
+
+        bool operator<(const Key& other) const {
+            return k1 < other.k1 || (k1 == other.k1 && k2 < other.k2);
+        }
+    };
+
+    static constexpr int infinity = 0x3fffffff;
+
+    bool initialized = false;
+    int rows = 0;
+    int cols = 0;
+    int stride = 0;
+    Point start;
+    Point goal;
+    int startIndex = 0;
+    int goalIndex = 0;
+    SearchRecorder recorder;
+
+    std::vector<int> g;
+    std::vector<int> rhs;
+    IndexedHeap<Key> openSet;
+    std::pmr::vector<Point> path;
+
+    void initialize(const GridView& grid, const Point& start, const Point& goal);
+    Key calculateKey(int index) const;
+    void updateVertex(const GridView& grid, int index);
+    void computeShortestPath(const GridView& grid);
+    void extractPath(const GridView& grid);
+    bool isPassable(const GridView& grid, int index) const;
+};
+
+#endif  // LPASTAR_H
@@ -0,0 +1,121 @@
+#include <climits>
+#include "Landmarks.h"
+
+Landmarks::Landmarks(int count) : wanted(std::max(count, 1)) {}
+
+void Landmarks::distancesFrom(const GridView& grid, int from, std::vector<int>& result, std::vector<int>& queue) const {
+    const int offsets[4] = { 1, -1, grid.stride, -grid.stride };
+
+    result.assign(grid.cellCount(), -1);
+    queue.clear();
+    result[from] = 0;
+    queue.push_back(from);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cell = queue[head];
+        for (int offset : offsets) {
+            // the wall border stops the walk at the edge
+            int neighbor = cell + offset;
+            if (result[neighbor] == -1 && !grid.isWall(neighbor)) {
+                result[neighbor] = result[cell] + 1;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+}
+
+void Landmarks::fill(std::vector<uint16_t>& table, size_t width, size_t landmark, const std::vector<int>& result) {
+    for (size_t cell = 0; cell < result.size(); ++cell) {
+        int distance = result[cell];
+        table[cell * width + landmark] = distance < 0 ? unreached : static_cast<uint16_t>(std::min(distance, static_cast<int>(far)));
+    }
+}
+
+void Landmarks::build(const GridView& grid) {
+    rows = grid.rows;
+    cols = grid.cols;
+    landmarks.clear();
+    distances.clear();
+
+    // start from the free cell closest to the middle; its area gets the landmarks
+    int seed = -1;
+    int seedDistance = INT_MAX;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int distance = std::abs(row - rows / 2) + std::abs(col - cols / 2);
+            if (distance < seedDistance && !grid.isWall(grid.index(Point(row, col)))) {
+                seed = grid.index(Point(row, col));
+                seedDistance = distance;
+            }
+        }
+    }
+    if (seed == -1) {
+        return;  // nothing passable
+    }
+
+    std::vector<int> result;
+    std::vector<int> queue;
+    distancesFrom(grid, seed, result, queue);
+
+    // farthest-point selection: the first landmark is the cell farthest from
+    // the seed, every next one the cell farthest from all landmarks so far
+    std::vector<int> nearest(result);
+    std::vector<int> picked;
+    std::vector<uint16_t> table(static_cast<size_t>(grid.cellCount()) * wanted);
+    while (static_cast<int>(picked.size()) < wanted) {
+        int next = -1;
+        for (int cell = 0; cell < grid.cellCount(); ++cell) {
+            if (nearest[cell] > 0 && (next == -1 || nearest[cell] > nearest[next])) {
+                next = cell;
+            }
+        }
+        if (next == -1) {
+            break;  // every reachable cell is a landmark already
+        }
+
+        distancesFrom(grid, next, result, queue);
+        fill(table, wanted, picked.size(), result);
+        for (int cell = 0; cell < grid.cellCount(); ++cell) {
+            // the seed itself is no landmark: forget its distances after the first pick
+            if (result[cell] >= 0) {
+                nearest[cell] = picked.empty() ? result[cell] : std::min(nearest[cell], result[cell]);
+            }
+        }
+        picked.push_back(next);
+    }
+
+    if (picked.empty()) {
+        return;  // a single free cell: no tables, estimate stays 0
+    }
+
+    // drop the columns of landmarks that were never picked
+    for (int cell : picked) {
+        landmarks.push_back(grid.point(cell));
+    }
+    size_t width = landmarks.size();
+    if (width == static_cast<size_t>(wanted)) {
+        distances.swap(table);
+        return;
+    }
+    distances.resize(static_cast<size_t>(grid.cellCount()) * width);
+    for (size_t cell = 0; cell < static_cast<size_t>(grid.cellCount()); ++cell) {
+        std::copy_n(&table[cell * wanted], width, &distances[cell * width]);
+    }
+}
+
+void Landmarks::update(const GridView& grid) {
+    bool moved = !fits(grid);
+    for (size_t i = 0; i < landmarks.size() && !moved; ++i) {
+        moved = grid.isWall(grid.index(landmarks[i]));
+    }
+    if (moved) {
+        build(grid);
+        return;
+    }
+
+    std::vector<int> result;
+    std::vector<int> queue;
+    for (size_t i = 0; i < landmarks.size(); ++i) {
+        distancesFrom(grid, grid.index(landmarks[i]), result, queue);
+        fill(distances, landmarks.size(), i, result);
+    }
+}
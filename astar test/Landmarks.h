@@ -0,0 +1,76 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include "Point.h"
+#include "GridStorage.h"
+
+// Landmark distances for the ALT heuristic (A*, Landmarks, Triangle
+// inequality; Goldberg and Harrelson). A few landmark cells are picked far
+// apart, and the walking distance from each of them to every cell is stored.
+// For any landmark L, |d(L, a) - d(L, b)| never exceeds the distance between
+// a and b, so the largest of these over all landmarks is an admissible and
+// consistent heuristic that knows about walls, where Manhattan only sees an
+// open field. Mazes and maps full of rooms gain the most.
+// Distances count steps (every passable cell costs 1); terrain only makes
+// paths dearer, so the bound holds for weighted searches too.
+class Landmarks {
+public:
+    explicit Landmarks(int count = 16);
+
+    // Picks the landmarks by farthest-point selection, then fills the tables.
+    void build(const GridView& grid);
+
+    // Refills the tables after the grid changed, keeping the landmarks unless
+    // one of them became a wall or the grid size changed (then as build).
+    // Until then estimates may be too high where walls were removed.
+    void update(const GridView& grid);
+
+    bool isBuilt() const { return !landmarks.empty(); }
+    // Whether the tables were built for a grid of this size.
+    bool fits(const GridView& grid) const { return isBuilt() && grid.rows == rows && grid.cols == cols; }
+
+    // May be fewer than asked for when the free area is too small.
+    int count() const { return static_cast<int>(landmarks.size()); }
+    const std::vector<Point>& points() const { return landmarks; }
+    size_t memoryBytes() const { return distances.size() * sizeof(uint16_t); }
+
+    // Lower bound on the steps between two cells (GridView::index), 0 if the
+    // landmarks know nothing about them.
+    int estimate(int from, int to) const {
+        const uint16_t* a = distances.data() + static_cast<size_t>(from) * landmarks.size();
+        const uint16_t* b = distances.data() + static_cast<size_t>(to) * landmarks.size();
+        int best = 0;
+        for (size_t i = 0; i < landmarks.size(); ++i) {
+            // a cell the landmark cannot reach says nothing; neighbors are never
+            // split that way, so skipping it keeps the estimate consistent
+            if (a[i] != unreached && b[i] != unreached) {
+                best = std::max(best, std::abs(a[i] - b[i]));
+            }
+        }
+        return best;
+    }
+
+private:
+    // 2 bytes a cell and landmark. Longer distances are stored as far, which
+    // is still a lower bound on them: clamping never moves two neighbors more
+    // than 1 apart, so differences stay consistent, where skipping clamped
+    // entries would drop the estimate by thousands between two neighbors.
+    static constexpr uint16_t far = 0xfffe;
+    static constexpr uint16_t unreached = 0xffff;  // the sentinel estimate skips
+
+    int wanted;
+    int rows = 0;
+    int cols = 0;
+    std::vector<Point> landmarks;
+    std::vector<uint16_t> distances;  // cell-major: the landmarks of a cell share a cache line
+
+    // Walking distances from one cell to all others, -1 where it cannot go.
+    void distancesFrom(const GridView& grid, int from, std::vector<int>& result, std::vector<int>& queue) const;
+    static void fill(std::vector<uint16_t>& table, size_t width, size_t landmark, const std::vector<int>& result);
+};
+
+#endif  // LANDMARKS_H
@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Maps.h"
+
+namespace {
+    constexpr int roomSize = 16;
+
+    // std::uniform_int_distribution differs between standard libraries;
+    // plain modulo keeps generated maps identical everywhere.
+    int pick(std::mt19937& rng, int count) {
+        return static_cast<int>(rng() % static_cast<unsigned>(count));
+    }
+
+    void generateRandom(GridStorage& grid, std::mt19937& rng, double density) {
+        double threshold = density * 4294967296.0;
+        for (int row = 0; row < grid.getRows(); ++row) {
+            for (int col = 0; col < grid.getCols(); ++col) {
+                if (rng() < threshold) {
+                    grid.set(row, col, CELL_WALL);
+                }
+            }
+        }
+    }
+
+    void generateTerrain(GridStorage& grid, std::mt19937& rng, double density) {
+        generateRandom(grid, rng, density);
+
+        // square patches of costlier ground, roughly one per 16x16 area
+        int patches = std::max(1, grid.getRows() * grid.getCols() / 256);
+        for (int i = 0; i < patches; ++i) {
+            int top = pick(rng, grid.getRows());
+            int left = pick(rng, grid.getCols());
+            int size = 4 + pick(rng, 12);
+            uint8_t terrain = terrainCell(2 + pick(rng, 8));
+
+            for (int row = top; row < std::min(top + size, grid.getRows()); ++row) {
+                for (int col = left; col < std::min(left + size, grid.getCols()); ++col) {
+                    if (grid.get(row, col) != CELL_WALL) {
+                        grid.set(row, col, terrain);
+                    }
+                }
+            }
+        }
+    }
+
+    void generateMaze(GridStorage& grid, std::mt19937& rng) {
+        // rooms sit on even coordinates, the walls between them on odd ones
+        int rows = grid.getRows();
+        int cols = grid.getCols();
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                grid.set(row, col, CELL_WALL);
+            }
+        }
+
+        std::vector<bool> visited(static_cast<size_t>(rows) * cols, false);
+        std::vector<std::pair<int, int>> stack = { {0, 0} };
+        visited[0] = true;
+        grid.set(0, 0, 0);
+
+        const int directions[4][2] = { {0, 2}, {0, -2}, {2, 0}, {-2, 0} };
+        while (!stack.empty()) {
+            auto [row, col] = stack.back();
+
+            int options[4];
+            int count = 0;
+            for (int d = 0; d < 4; ++d) {
+                int nr = row + directions[d][0];
+                int nc = col + directions[d][1];
+                if (nr >= 0 && nr < rows && nc >= 0 && nc < cols && !visited[nr * cols + nc]) {
+                    options[count++] = d;
+                }
+            }
+
+            if (count == 0) {
+                stack.pop_back();
+                continue;
+            }
+
+            const int* direction = directions[options[pick(rng, count)]];
+            int nr = row + direction[0];
+            int nc = col + direction[1];
+            grid.set(row + direction[0] / 2, col + direction[1] / 2, 0);
+            grid.set(nr, nc, 0);
+            visited[nr * cols + nc] = true;
+            stack.emplace_back(nr, nc);
+        }
+    }
+
+    void generateRooms(GridStorage& grid, std::mt19937& rng) {
+        int rows = grid.getRows();
+        int cols = grid.getCols();
+
+        for (int row = roomSize - 1; row < rows; row += roomSize) {
+            for (int col = 0; col < cols; ++col) {
+                grid.set(row, col, CELL_WALL);
+            }
+        }
+        for (int col = roomSize - 1; col < cols; col += roomSize) {
+            for (int row = 0; row < rows; ++row) {
+                grid.set(row, col, CELL_WALL);
+            }
+        }
+
+        // one two-cell door in every wall segment between neighbouring rooms
+        for (int top = 0; top < rows; top += roomSize) {
+            for (int left = 0; left < cols; left += roomSize) {
+                int wallRow = top + roomSize - 1;
+                int wallCol = left + roomSize - 1;
+                if (wallRow < rows) {
+                    int span = std::min(roomSize - 1, cols - left);  // the last room may be cut off
+                    int door = left + pick(rng, std::max(span - 1, 1));
+                    for (int col = door; col < door + 2 && col < cols; ++col) {
+                        grid.set(wallRow, col, 0);
+                    }
+                }
+                if (wallCol < cols) {
+                    int span = std::min(roomSize - 1, rows - top);
+                    int door = top + pick(rng, std::max(span - 1, 1));
+                    for (int row = door; row < door + 2 && row < rows; ++row) {
+                        grid.set(row, wallCol, 0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+GridStorage generateMap(MapKind kind, int rows, int cols, unsigned seed, double density) {
+    GridStorage grid(rows, cols, 0);
+    std::mt19937 rng(seed);
+
+    switch (kind) {
+    case MapKind::Random:
+        generateRandom(grid, rng, density);
+        break;
+
+    case MapKind::Maze:
+        generateMaze(grid, rng);
+        break;
+
+    case MapKind::Rooms:
+        generateRooms(grid, rng);
+        break;
+
+    case MapKind::Terrain:
+        generateTerrain(grid, rng, density);
+        break;
+
+    case MapKind::Open:
+        break;
+    }
+
+    return grid;
+}
+
+bool parseMapKind(const std::string& name, MapKind& kind) {
+    if (name == "random") {
+        kind = MapKind::Random;
+    }
+    else if (name == "maze") {
+        kind = MapKind::Maze;
+    }
+    else if (name == "rooms") {
+        kind = MapKind::Rooms;
+    }
+    else if (name == "terrain") {
+        kind = MapKind::Terrain;
+    }
+    else if (name == "open") {
+        kind = MapKind::Open;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+GridStorage loadMovingAIMap(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open map file: " + path);
+    }
+
+    int height = -1;
+    int width = -1;
+    std::string word;
+    while (in >> word && word != "map") {
+        if (word == "height") {
+            in >> height;
+        }
+        else if (word == "width") {
+            in >> width;
+        }
+        else if (word == "type") {
+            in >> word;
+        }
+    }
+
+    if (word != "map" || height <= 0 || width <= 0) {
+        throw std::runtime_error("Invalid map header: " + path);
+    }
+
+    GridStorage grid(height, width, 0);
+    std::string line;
+    std::getline(in, line);  // rest of the "map" line
+    for (int row = 0; row < height; ++row) {
+        if (!std::getline(in, line) || static_cast<int>(line.size()) < width) {
+            throw std::runtime_error("Truncated map data: " + path);
+        }
+        for (int col = 0; col < width; ++col) {
+            char c = line[col];
+            bool passable = c == '.' || c == 'G' || c == 'S';
+            grid.set(row, col, passable ? 0 : CELL_WALL);
+        }
+    }
+
+    return grid;
+}
+
+std::vector<ScenarioEntry> loadMovingAIScenario(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open scenario file: " + path);
+    }
+
+    std::vector<ScenarioEntry> entries;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line == "\r" || line.compare(0, 7, "version") == 0) {
+            continue;
+        }
+
+        ScenarioEntry entry;
+        int startX;
+        int startY;
+        int goalX;
+        int goalY;
+        std::istringstream fields(line);
+        if (!(fields >> entry.bucket >> entry.map >> entry.width >> entry.height >> startX >> startY >> goalX >> goalY >> entry.optimalLength)) {
+            throw std::runtime_error("Invalid scenario line in " + path + ": " + line);
+        }
+        entry.start = Point(startY, startX);
+        entry.goal = Point(goalY, goalX);
+        entries.push_back(entry);
+    }
+
+    return entries;
+}
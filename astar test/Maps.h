@@ -0,0 +1,44 @@
+#ifndef MAPS_H
+#define MAPS_H
+
+#include <string>
+#include <vector>
+#include "Point.h"
+#include "GridStorage.h"
+
+enum class MapKind {
+    Random,  // independent obstacles with the given density
+    Maze,    // one-cell corridors carved by a depth-first walk
+    Rooms,   // square rooms joined by doors
+    Terrain, // random walls plus patches costing 2..9 to enter (CELL_TERRAIN)
+    Open,    // no walls at all
+};
+
+// Same seed, size and density always give the same map, on every platform.
+GridStorage generateMap(MapKind kind, int rows, int cols, unsigned seed, double density = 0.2);
+
+// Accepts "random", "maze", "rooms", "terrain" or "open".
+bool parseMapKind(const std::string& name, MapKind& kind);
+
+// MovingAI benchmark format (https://movingai.com/benchmarks/formats.html):
+// '.', 'G' and 'S' are passable, everything else becomes a wall.
+// Throws std::runtime_error if the file cannot be read or parsed.
+GridStorage loadMovingAIMap(const std::string& path);
+
+// One line of a MovingAI .scen file. MovingAI counts x along a row, so start
+// and goal are converted to this repo's (row, col) points.
+struct ScenarioEntry {
+    int bucket = 0;
+    std::string map;  // file name of the map the entry belongs to
+    int width = 0;
+    int height = 0;
+    Point start;
+    Point goal;
+    double optimalLength = 0.0;  // 8-connected, diagonals cost sqrt(2)
+};
+
+// MovingAI scenario format, "version 1" header optional.
+// Throws std::runtime_error if the file cannot be read or parsed.
+std::vector<ScenarioEntry> loadMovingAIScenario(const std::string& path);
+
+#endif  // MAPS_H
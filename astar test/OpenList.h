@@ -0,0 +1,169 @@
+#ifndef OPENLIST_H
+#define OPENLIST_H
+
+#include <vector>
+#include <cstddef>
+#include <memory_resource>
+
+// Min-heap over dense integer ids (cell indices) with a per-id handle, so that
+// membership is O(1) and decrease-key is O(log n) instead of a linear scan.
+// Arity 4 keeps the tree shallow and the children of a node on one cache line.
+template <typename Key, int Arity = 4>
+class IndexedHeap {
+public:
+    static constexpr int npos = -1;
+
+    explicit IndexedHeap(size_t capacity = 0, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : heap(resource), position(capacity, npos, resource) {}
+
+    // Ids must lie in [0, capacity). Drops the current contents; the handle
+    // table is only reallocated when the capacity actually changes.
+    void resize(size_t capacity) {
+        if (capacity == position.size()) {
+            clear();
+            return;
+        }
+        heap.clear();
+        position.assign(capacity, npos);
+    }
+
+    size_t capacity() const { return position.size(); }
+    size_t size() const { return heap.size(); }
+    bool empty() const { return heap.empty(); }
+
+    bool contains(int id) const { return position[id] != npos; }
+    const Key& key(int id) const { return heap[position[id]].key; }
+
+    int top() const { return heap[0].id; }
+    // Queued ids in heap order, for scans over the whole list.
+    int idAt(size_t i) const { return heap[i].id; }
+    const Key& topKey() const { return heap[0].key; }
+
+    void push(int id, const Key& key) {
+        position[id] = static_cast<int>(heap.size());
+        heap.push_back({ key, id });
+        siftUp(position[id]);
+    }
+
+    // key must not be greater than the current key of id
+    void decreaseKey(int id, const Key& key) {
+        int pos = position[id];
+        heap[pos].key = key;
+        siftUp(pos);
+    }
+
+    // Inserts id, or lowers its key if it is already queued with a worse one.
+    // Returns false if id was already queued with a key at least as good.
+    bool pushOrDecrease(int id, const Key& key) {
+        if (!contains(id)) {
+            push(id, key);
+            return true;
+        }
+        if (key < heap[position[id]].key) {
+            decreaseKey(id, key);
+            return true;
+        }
+        return false;
+    }
+
+    // Moves id to key in either direction (LPA* raises keys as well as lowering them).
+    void update(int id, const Key& key) {
+        int pos = position[id];
+        bool lower = key < heap[pos].key;
+        heap[pos].key = key;
+        if (lower) {
+            siftUp(pos);
+        }
+        else {
+            siftDown(pos);
+        }
+    }
+
+    void remove(int id) {
+        int pos = position[id];
+        position[id] = npos;
+
+        Entry last = heap.back();
+        heap.pop_back();
+        if (pos < static_cast<int>(heap.size())) {
+            place(pos, last);
+            siftUp(pos);
+            siftDown(position[last.id]);
+        }
+    }
+
+    int pop() {
+        int id = heap[0].id;
+        position[id] = npos;
+
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            position[last.id] = 0;
+            siftDown(0);
+        }
+        return id;
+    }
+
+    // O(size), not O(capacity): only the queued ids get their handle reset.
+    void clear() {
+        for (const Entry& entry : heap) {
+            position[entry.id] = npos;
+        }
+        heap.clear();
+    }
+
+private:
+    struct Entry {
+        Key key;
+        int id;
+    };
+
+    std::pmr::vector<Entry> heap;
+    std::pmr::vector<int> position;  // index into heap, npos if not queued
+
+    void place(int pos, const Entry& entry) {
+        heap[pos] = entry;
+        position[entry.id] = pos;
+    }
+
+    void siftUp(int pos) {
+        Entry entry = heap[pos];
+        while (pos > 0) {
+            int parent = (pos - 1) / Arity;
+            if (!(entry.key < heap[parent].key)) {
+                break;
+            }
+            place(pos, heap[parent]);
+            pos = parent;
+        }
+        place(pos, entry);
+    }
+
+    void siftDown(int pos) {
+        Entry entry = heap[pos];
+        int count = static_cast<int>(heap.size());
+        while (true) {
+            int first = pos * Arity + 1;
+            if (first >= count) {
+                break;
+            }
+            int last = first + Arity < count ? first + Arity : count;
+            int best = first;
+            for (int child = first + 1; child < last; ++child) {
+                if (heap[child].key < heap[best].key) {
+                    best = child;
+                }
+            }
+            if (!(heap[best].key < entry.key)) {
+                break;
+            }
+            place(pos, heap[best]);
+            pos = best;
+        }
+        place(pos, entry);
+    }
+};
+
+#endif  // OPENLIST_H
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "ParallelAStar.h"
+
+ParallelAStar::ParallelAStar(unsigned threadCount, int tileSize)
+    : pool(std::min(threadCount, 65536u)), tileSize(std::max(tileSize, 1)) {
+    for (unsigned i = 0; i < pool.threadCount(); ++i) {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->outgoing.assign(pool.threadCount(), nullptr);
+    }
+}
+
+ParallelAStar::~ParallelAStar() {
+    // a query always ends with every batch taken in; this is for exceptions
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        for (Batch* batch : worker->outgoing) {
+            delete batch;
+        }
+        for (Batch* batch = worker->inbox.load(); batch != nullptr;) {
+            Batch* next = batch->next;
+            delete batch;
+            batch = next;
+        }
+    }
+}
+
+void ParallelAStar::assignOwners(const GridView& grid) {
+    if (grid.rows == rows && grid.cols == cols && !owners.empty()) {
+        return;
+    }
+    rows = grid.rows;
+    cols = grid.cols;
+
+    // scattered by a hash so that a front moving across the map keeps every thread busy
+    unsigned threads = threadCount();
+    int tilesAcross = (cols + tileSize - 1) / tileSize;
+    owners.assign(static_cast<size_t>(grid.cellCount()), 0);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            uint32_t tile = static_cast<uint32_t>((row / tileSize) * tilesAcross + col / tileSize);
+            uint32_t hash = tile * 2654435761u;
+            owners[grid.index(Point(row, col))] = static_cast<uint16_t>((hash ^ (hash >> 16)) % threads);
+        }
+    }
+}
+
+int ParallelAStar::heuristic(int cell) const {
+    return abs(cell / grid.stride - goalIndex / grid.stride) + abs(cell % grid.stride - goalIndex % grid.stride);
+}
+
+void ParallelAStar::relax(Worker& worker, int cell, int g, int parent) {
+    if (g >= state.g(cell)) {
+        return;
+    }
+    if (state.status(cell) == SearchState::Closed) {
+        ++worker.stats.reopenings;  // reached out of order, through a longer way first
+    }
+    state.open(cell, g, parent);
+
+    if (cell == goalIndex) {
+        bestCost.store(g);  // only the goal's owner writes it, and only ever lower
+        return;
+    }
+
+    int f = g + heuristic(cell);
+    if (f >= bestCost.load(std::memory_order_relaxed)) {
+        return;  // cannot lead to a shorter path
+    }
+    worker.openList.push_back({ f, g, cell });
+    std::push_heap(worker.openList.begin(), worker.openList.end());
+    ++worker.stats.pushed;
+    worker.stats.peakOpenSize = std::max(worker.stats.peakOpenSize, static_cast<int>(worker.openList.size()));
+}
+
+void ParallelAStar::send(unsigned to, Batch* batch) {
+    // counted before it is visible, so the receiver can never count it off first
+    pending.fetch_add(1);
+    std::atomic<Batch*>& inbox = workers[to]->inbox;
+    batch->next = inbox.load(std::memory_order_relaxed);
+    while (!inbox.compare_exchange_weak(batch->next, batch, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+void ParallelAStar::flush(Worker& worker) {
+    for (unsigned to = 0; to < worker.outgoing.size(); ++to) {
+        if (worker.outgoing[to] != nullptr) {
+            send(to, worker.outgoing[to]);
+            worker.outgoing[to] = nullptr;
+            ++worker.sent;
+        }
+    }
+}
+
+bool ParallelAStar::takeInbox(Worker& worker, bool& busy) {
+    Batch* batch = worker.inbox.exchange(nullptr, std::memory_order_acquire);
+    if (batch == nullptr) {
+        return false;
+    }
+
+    // busy again before the batches stop counting, or pending could touch 0
+    if (!busy) {
+        pending.fetch_add(1);
+        busy = true;
+    }
+    while (batch != nullptr) {
+        for (const Message& message : batch->messages) {
+            relax(worker, message.cell, message.g, message.parent);
+        }
+        Batch* next = batch->next;
+        delete batch;
+        batch = next;
+        pending.fetch_sub(1);
+    }
+    return true;
+}
+
+void ParallelAStar::expand(unsigned id) {
+    Worker& worker = *workers[id];
+    const int offsets[4] = { 1, -1, grid.stride, -grid.stride };
+
+    for (int expanded = 0; expanded < expansionsPerRound && !worker.openList.empty();) {
+        Queued top = worker.openList.front();
+        if (top.f >= bestCost.load(std::memory_order_acquire)) {
+            worker.openList.clear();  // the rest is no better
+            break;
+        }
+        std::pop_heap(worker.openList.begin(), worker.openList.end());
+        worker.openList.pop_back();
+
+        // improved since it was pushed: the better entry is handled on its own
+        if (top.g != state.g(top.cell)) {
+            ++worker.stats.stalePops;
+            continue;
+        }
+        state.close(top.cell);
+        ++worker.stats.expanded;
+        ++expanded;
+
+        for (int offset : offsets) {
+            int neighbor = top.cell + offset;
+            if (grid.isWall(neighbor) || top.g + 1 + heuristic(neighbor) >= bestCost.load(std::memory_order_relaxed)) {
+                continue;
+            }
+
+            unsigned owner = owners[neighbor];
+            if (owner == id) {
+                relax(worker, neighbor, top.g + 1, top.cell);
+                continue;
+            }
+
+            Batch*& batch = worker.outgoing[owner];
+            if (batch == nullptr) {
+                batch = new Batch();
+                batch->messages.reserve(batchSize);
+            }
+            batch->messages.push_back({ neighbor, top.g + 1, top.cell });
+            if (batch->messages.size() == batchSize) {
+                send(owner, batch);
+                batch = nullptr;
+                ++worker.sent;
+            }
+        }
+    }
+}
+
+void ParallelAStar::run(unsigned id) {
+    Worker& worker = *workers[id];
+    bool busy = true;  // pending starts with every thread busy
+
+    while (true) {
+        takeInbox(worker, busy);
+        expand(id);
+        flush(worker);
+
+        if (!worker.openList.empty() || worker.inbox.load(std::memory_order_relaxed) != nullptr) {
+            continue;
+        }
+
+        // out of work; only a batch from a busy thread can bring more, so once
+        // nobody is busy and nothing is underway the search is over
+        if (busy) {
+            busy = false;
+            pending.fetch_sub(1);
+        }
+        if (pending.load() == 0) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+const std::vector<Point>& ParallelAStar::findPath(const GridView& newGrid, const Point& start, const Point& goal) {
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    path.clear();
+    stats = SearchStats();
+    batches = 0;
+    if (newGrid.empty() || !newGrid.contains(start) || !newGrid.contains(goal)) {
+        return path;
+    }
+
+    grid = newGrid;
+    assignOwners(grid);
+    state.reset(grid.cellCount());
+    goalIndex = grid.index(goal);
+    bestCost.store(infinity);
+    pending.store(static_cast<long long>(workers.size()));
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        worker->openList.clear();
+        worker->stats = SearchStats();
+        worker->sent = 0;
+    }
+
+    int startIndex = grid.index(start);
+    relax(*workers[owners[startIndex]], startIndex, 0, SearchState::noParent);
+
+    pool.run(workers.size(), [this](size_t item, unsigned) { run(static_cast<unsigned>(item)); });
+
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        stats.expanded += worker->stats.expanded;
+        stats.pushed += worker->stats.pushed;
+        stats.stalePops += worker->stats.stalePops;
+        stats.reopenings += worker->stats.reopenings;
+        stats.peakOpenSize = std::max(stats.peakOpenSize, worker->stats.peakOpenSize);
+        batches += worker->sent;
+    }
+
+    if (bestCost.load() < infinity) {
+        for (int cell = goalIndex; cell != SearchState::noParent; cell = state.parent(cell)) {
+            path.push_back(grid.point(cell));
+        }
+        std::reverse(path.begin(), path.end());
+    }
+    stats.micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    return path;
+}
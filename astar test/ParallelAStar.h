@@ -0,0 +1,112 @@
+#ifndef PARALLELASTAR_H
+#define PARALLELASTAR_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "Point.h"
+#include "GridStorage.h"
+#include "SearchState.h"
+#include "SearchStats.h"
+#include "WorkerPool.h"
+
+// Hash Distributed A* (Kishimoto, Fukunaga, Botea) for one long query on a
+// huge map: every thread owns the cells of a hashed set of square tiles and
+// runs A* over them with its own open list. A cell reached through a cell of
+// another thread is sent to its owner in batches over lock-free queues; the
+// owner alone writes its g and parent, so the per-cell state needs no locks.
+// Tiles rather than single cells keep most neighbors on the same thread,
+// which cuts the messages and keeps threads off each other's cache lines.
+// The first path to the goal is only an upper bound: threads go on until no
+// open cell could beat it and no message is underway, which makes the result
+// optimal, the same length as AStar's Standard mode.
+// 4-connected, every passable cell costs 1. No trace: cells are expanded out
+// of order on many threads.
+class ParallelAStar {
+public:
+    // threadCount includes the calling thread; 0 picks one per hardware thread.
+    // Owners change every tileSize cells in both directions.
+    explicit ParallelAStar(unsigned threadCount = 0, int tileSize = 8);
+    ~ParallelAStar();
+
+    ParallelAStar(const ParallelAStar&) = delete;
+    ParallelAStar& operator=(const ParallelAStar&) = delete;
+
+    // Empty if there is no path. Result stays valid until the next query.
+    // Not reentrant: one query at a time per ParallelAStar.
+    const std::vector<Point>& findPath(const GridView& grid, const Point& start, const Point& goal);
+
+    unsigned threadCount() const { return pool.threadCount(); }
+
+    // Summed over the threads; peakOpenSize is the largest open list of one thread.
+    const SearchStats& lastStats() const { return stats; }
+    // Batches of cells sent between threads by the last query.
+    unsigned long long lastBatches() const { return batches; }
+
+private:
+    struct Message {
+        int cell;
+        int g;
+        int parent;
+    };
+
+    // Intrusive node of an inbox; a whole batch goes over with one push.
+    struct Batch {
+        Batch* next = nullptr;
+        std::vector<Message> messages;
+    };
+
+    struct Queued {
+        int f;
+        int g;
+        int cell;
+
+        // min-heap on f; deeper first among equals, which reaches the goal sooner
+        bool operator<(const Queued& other) const {
+            return f > other.f || (f == other.f && g < other.g);
+        }
+    };
+
+    // Cache-line aligned: the inbox is written by every other thread.
+    struct alignas(64) Worker {
+        std::atomic<Batch*> inbox{ nullptr };  // lock-free stack of batches
+        std::vector<Queued> openList;
+        std::vector<Batch*> outgoing;          // one batch being filled per destination
+        SearchStats stats;
+        unsigned long long sent = 0;
+    };
+
+    static constexpr int infinity = 0x3fffffff;
+    static constexpr size_t batchSize = 64;
+    static constexpr int expansionsPerRound = 32;  // between checks of the inbox
+
+    WorkerPool pool;
+    int tileSize;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    int rows = 0;
+    int cols = 0;
+    std::vector<uint16_t> owners;  // per padded cell
+    SearchState state;             // each cell written by its owner only
+
+    // per query
+    GridView grid;
+    int goalIndex = 0;
+    std::atomic<int> bestCost{ infinity };  // length of the best path found, written by the goal's owner
+    std::atomic<long long> pending{ 0 };    // busy threads plus batches not yet taken in
+    std::vector<Point> path;
+    SearchStats stats;
+    unsigned long long batches = 0;
+
+    void assignOwners(const GridView& grid);
+    int heuristic(int cell) const;
+    void relax(Worker& worker, int cell, int g, int parent);
+    void send(unsigned to, Batch* batch);
+    void flush(Worker& worker);
+    bool takeInbox(Worker& worker, bool& busy);
+    void expand(unsigned id);
+    void run(unsigned id);
+};
+
+#endif  // PARALLELASTAR_H
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <stdexcept>
+#include "PathService.h"
+#include "ARAStar.h"
+
+PathService::PathService(const GridView& view, int sliceExpansions)
+    : slice_expansions(std::max(sliceExpansions, 1)), grid(std::make_shared<GridStorage>(view)) {
+    worker = std::thread(&PathService::run, this);
+}
+
+PathService::~PathService() {
+    {
+        std::lock_guard<std::mutex> guard(state_lock);
+        stopping = true;
+    }
+    work_ready.notify_one();
+    worker.join();
+}
+
+void PathService::setCell(int row, int col, uint8_t value) {
+    {
+        std::lock_guard<std::mutex> guard(state_lock);
+        if (row < 0 || row >= grid->getRows() || col < 0 || col >= grid->getCols()) {
+            throw std::out_of_range("Invalid cell position");
+        }
+        if (grid->get(row, col) == value) {
+            return;
+        }
+
+        // Searches only ever share the grid under this lock, so the count is
+        // exact: anyone else holding it is a running search.
+        if (grid.use_count() > 1) {
+            grid = std::make_shared<GridStorage>(*grid);
+            ++counters.snapshotCopies;
+        }
+        grid->set(row, col, value);
+        edited(Clock::now());
+    }
+    work_ready.notify_one();
+}
+
+void PathService::setEndpoints(const Point& newStart, const Point& newGoal) {
+    {
+        std::lock_guard<std::mutex> guard(state_lock);
+        GridView view = grid->view();
+        if (!view.contains(newStart) || !view.contains(newGoal)) {
+            throw std::out_of_range("Invalid cell position");
+        }
+
+        start = newStart;
+        goal = newGoal;
+        has_endpoints = true;
+        edited(Clock::now());
+    }
+    work_ready.notify_one();
+}
+
+void PathService::edited(Clock::time_point now) {
+    unsigned long long version = latest_version.load(std::memory_order_relaxed) + 1;
+    latest_version.store(version, std::memory_order_release);
+    unpublished_edits.emplace_back(version, now);
+}
+
+bool PathService::hasNewResult() const {
+    return (middle.load(std::memory_order_acquire) & freshBit) != 0;
+}
+
+const PathResult& PathService::latest() {
+    if (hasNewResult()) {
+        front = middle.exchange(front, std::memory_order_acq_rel) & ~freshBit;
+    }
+    return slots[front];
+}
+
+bool PathService::waitFor(unsigned long long version, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> guard(state_lock);
+    return published.wait_for(guard, timeout, [this, version] { return published_version >= version; });
+}
+
+PathService::Statistics PathService::statistics() const {
+    std::lock_guard<std::mutex> guard(state_lock);
+    Statistics statistics = counters;
+    statistics.meanLatencyMicros = counters.published == 0 ? 0.0 : latency_total / counters.published;
+    return statistics;
+}
+
+void PathService::run() {
+    ARAStar search(1.0);  // weight 1: plain A*, sliced by the budget
+    ARAStar::Budget budget;
+    budget.maxExpansions = slice_expansions;
+    unsigned long long searched = 0;
+    int cancelsInRow = 0;
+
+    std::unique_lock<std::mutex> guard(state_lock);
+    while (true) {
+        work_ready.wait(guard, [this, &searched] {
+            return stopping || (has_endpoints && latest_version.load(std::memory_order_relaxed) != searched);
+        });
+        if (stopping) {
+            return;
+        }
+
+        unsigned long long version = latest_version.load(std::memory_order_relaxed);
+        std::shared_ptr<const GridStorage> snapshot = grid;
+        Point from = start;
+        Point to = goal;
+        ++counters.started;
+        guard.unlock();
+
+        PathResult& result = slots[back];
+        result.stats = SearchStats();
+        search.invalidate();
+        GridView view = snapshot->view();
+        bool cancelled = false;
+        while (true) {
+            if (cancelsInRow < maxCancelsInRow && latest_version.load(std::memory_order_acquire) != version) {
+                cancelled = true;  // outdated: move on to the newest state
+                break;
+            }
+
+            const std::pmr::vector<Point>& path = search.findPath(view, from, to, budget);
+            const SearchStats& stats = search.lastStats();
+            result.stats.expanded += stats.expanded;
+            result.stats.pushed += stats.pushed;
+            result.stats.reopenings += stats.reopenings;
+            result.stats.peakOpenSize = std::max(result.stats.peakOpenSize, stats.peakOpenSize);
+            result.stats.micros += stats.micros;
+
+            if (search.isFinished()) {
+                result.path.assign(path.begin(), path.end());
+                result.cost = path.empty() ? 0 : search.lastCost();
+                break;
+            }
+        }
+
+        guard.lock();
+        snapshot.reset();  // under the lock, see setCell
+        searched = version;
+        if (cancelled) {
+            ++counters.cancelled;
+            ++cancelsInRow;
+            continue;
+        }
+        cancelsInRow = 0;
+
+        result.version = version;
+        result.start = from;
+        result.goal = to;
+        publish(version);
+    }
+}
+
+void PathService::publish(unsigned long long version) {
+    // latency of the oldest edit this result is the first to answer
+    double latency = 0.0;
+    if (!unpublished_edits.empty() && unpublished_edits.front().first <= version) {
+        latency = std::chrono::duration<double, std::micro>(Clock::now() - unpublished_edits.front().second).count();
+    }
+    while (!unpublished_edits.empty() && unpublished_edits.front().first <= version) {
+        unpublished_edits.pop_front();
+    }
+
+    slots[back].latencyMicros = latency;
+    back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & ~freshBit;
+
+    published_version = version;
+    ++counters.published;
+    latency_total += latency;
+    counters.maxLatencyMicros = std::max(counters.maxLatencyMicros, latency);
+    published.notify_all();
+}
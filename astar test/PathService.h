@@ -0,0 +1,114 @@
+#ifndef PATHSERVICE_H
+#define PATHSERVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <condition_variable>
+#include "Point.h"
+#include "GridStorage.h"
+#include "SearchStats.h"
+
+// A finished search, as published by PathService.
+struct PathResult {
+    std::vector<Point> path;       // empty if the goal cannot be reached
+    unsigned long long version = 0;  // PathService::version() the path was computed for, 0 before the first
+    Point start;
+    Point goal;
+    int cost = 0;                  // terrain cost of the cells after the start
+    SearchStats stats;             // summed over the slices of the search
+    double latencyMicros = 0.0;    // oldest edit it answers to publication
+};
+
+// Searches on a worker thread so that edits and rendering never wait for one.
+// The service keeps its own copy of the grid. Edits are applied to it copy on
+// write: a search holds a snapshot, and the first edit arriving while it runs
+// copies the grid instead of changing it under the search. A search whose
+// snapshot is outdated is cancelled between slices of expansions, so the
+// worker moves on to the newest state. After maxCancelsInRow cancellations the
+// next search runs to the end regardless: under a steady stream of edits
+// nothing would be published otherwise.
+// Finished paths are handed to the reader through a lock-free triple buffer:
+// publishing never blocks on the reader and reading never blocks on the worker.
+// Searches are 4-connected, optimal and honor terrain costs.
+//
+// setCell/setEndpoints may be called from any thread; hasNewResult/latest
+// belong to one reader thread (the renderer).
+class PathService {
+public:
+    // Service-wide counters, see statistics().
+    struct Statistics {
+        unsigned long long started = 0;
+        unsigned long long cancelled = 0;
+        unsigned long long published = 0;
+        unsigned long long snapshotCopies = 0;  // grids copied because a search held the old one
+        double meanLatencyMicros = 0.0;
+        double maxLatencyMicros = 0.0;
+    };
+
+    // Copies grid; sliceExpansions is how much search runs between checks for
+    // newer edits.
+    explicit PathService(const GridView& grid, int sliceExpansions = 1024);
+    ~PathService();
+
+    PathService(const PathService&) = delete;
+    PathService& operator=(const PathService&) = delete;
+
+    void setCell(int row, int col, uint8_t value);
+    void setEndpoints(const Point& start, const Point& goal);
+    // Bumped by every setCell and setEndpoints call.
+    unsigned long long version() const { return latest_version.load(std::memory_order_acquire); }
+
+    // Reader thread only. True if latest() would return something newer than last time.
+    bool hasNewResult() const;
+    // Reader thread only. Valid until the next latest() call.
+    const PathResult& latest();
+
+    // Blocks until a result for version or later is published, or timeout
+    // passes; true if it was published. For tests and headless benchmarks.
+    bool waitFor(unsigned long long version, std::chrono::milliseconds timeout);
+
+    Statistics statistics() const;
+
+    static constexpr int maxCancelsInRow = 2;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int slice_expansions;
+
+    mutable std::mutex state_lock;
+    std::condition_variable work_ready;
+    std::condition_variable published;
+    std::shared_ptr<GridStorage> grid;  // newest state; shared with a search while it runs
+    Point start;
+    Point goal;
+    bool has_endpoints = false;
+    bool stopping = false;
+    std::deque<std::pair<unsigned long long, Clock::time_point>> unpublished_edits;  // version, time
+    unsigned long long published_version = 0;
+    Statistics counters;
+    double latency_total = 0.0;
+    std::atomic<unsigned long long> latest_version{ 0 };
+
+    // Triple buffer: the worker fills back, swaps it with middle and sets the
+    // fresh bit; the reader swaps middle with front when the bit is set.
+    static constexpr unsigned freshBit = 4;
+    PathResult slots[3];
+    std::atomic<unsigned> middle{ 1 };  // slot index | freshBit
+    unsigned front = 0;                 // reader's slot
+    unsigned back = 2;                  // worker's slot
+
+    std::thread worker;
+
+    void edited(Clock::time_point now);
+    void run();
+    void publish(unsigned long long version);
+};
+
+#endif  // PATHSERVICE_H
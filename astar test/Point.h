@@ -0,0 +1,28 @@
+#ifndef POINT_H
+#define POINT_H
+
+#include <functional>
+
+struct Point {
+    int x;
+    int y;
+
+    Point(int x = 0, int y = 0) : x(x), y(y) {}
+
+    bool operator==(const Point& other) const {
+        return x == other.x && y == other.y;
+    }
+};
+
+namespace std {
+    template <>
+    struct hash<Point> {
+        size_t operator()(const Point& p) const {
+            // pack both coordinates so neighbouring cells do not collide
+            unsigned long long packed = (static_cast<unsigned long long>(static_cast<unsigned int>(p.x)) << 32) | static_cast<unsigned int>(p.y);
+            return std::hash<unsigned long long>{}(packed);
+        }
+    };
+}
+
+#endif  // POINT_H
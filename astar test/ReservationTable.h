@@ -0,0 +1,159 @@
+#ifndef RESERVATIONTABLE_H
+#define RESERVATIONTABLE_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Which agent occupies a cell at a time step, for cooperative planning.
+// Holds depth consecutive time steps as a ring of layers, one small hash
+// table from cell index to agent per step: memory grows with the number of
+// reservations, not with grid size times window, and moving the window on
+// (advance) only clears the layers that fell out of it.
+class ReservationTable {
+public:
+    static constexpr int none = -1;
+
+    explicit ReservationTable(int depth = 17) : layers(depth > 0 ? depth : 1) {
+        clear(0);
+    }
+
+    // Time steps held at once.
+    int depth() const { return static_cast<int>(layers.size()); }
+    int firstTime() const { return base; }
+
+    // Forgets every reservation and holds from..from + depth() - 1.
+    void clear(int from) {
+        base = from;
+        for (Layer& layer : layers) {
+            layer.erase();
+        }
+    }
+
+    // Drops the steps before time and holds as many new ones after the window.
+    void advance(int time) {
+        if (time - base >= depth()) {
+            clear(time);
+            return;
+        }
+        for (; base < time; ++base) {
+            layerFor(base).erase();  // now holds base + depth()
+        }
+    }
+
+    // Outside the held steps nothing is reserved and reserve() is ignored.
+    bool holds(int time) const { return time >= base && time < base + depth(); }
+
+    int reservedBy(int cell, int time) const {
+        return holds(time) ? layerFor(time).find(cell) : none;
+    }
+
+    // Overwrites whatever the cell held at that time.
+    void reserve(int cell, int time, int agent) {
+        if (holds(time)) {
+            layerFor(time).insert(cell, agent);
+        }
+    }
+
+    // Removes the reservation if agent holds it.
+    void release(int cell, int time, int agent) {
+        if (holds(time)) {
+            layerFor(time).remove(cell, agent);
+        }
+    }
+
+private:
+    // Open addressing with linear probing; removal shifts the following
+    // entries back, so lookups never need tombstones.
+    struct Layer {
+        struct Slot {
+            int cell = none;
+            int agent = none;
+        };
+
+        std::vector<Slot> slots = std::vector<Slot>(16);
+        int count = 0;
+
+        size_t mask() const { return slots.size() - 1; }
+        size_t home(int cell) const { return (static_cast<uint32_t>(cell) * 2654435761u) & mask(); }
+
+        int find(int cell) const {
+            for (size_t i = home(cell);; i = (i + 1) & mask()) {
+                if (slots[i].cell == cell) {
+                    return slots[i].agent;
+                }
+                if (slots[i].cell == none) {
+                    return none;
+                }
+            }
+        }
+
+        void insert(int cell, int agent) {
+            if ((count + 1) * 2 > static_cast<int>(slots.size())) {
+                grow();
+            }
+            size_t i = home(cell);
+            while (slots[i].cell != none && slots[i].cell != cell) {
+                i = (i + 1) & mask();
+            }
+            if (slots[i].cell == none) {
+                ++count;
+            }
+            slots[i].cell = cell;
+            slots[i].agent = agent;
+        }
+
+        void remove(int cell, int agent) {
+            size_t i = home(cell);
+            while (slots[i].cell != cell) {
+                if (slots[i].cell == none) {
+                    return;
+                }
+                i = (i + 1) & mask();
+            }
+            if (slots[i].agent != agent) {
+                return;
+            }
+
+            // move later entries of the probe run into the hole where their
+            // home allows it
+            size_t hole = i;
+            for (size_t next = (hole + 1) & mask(); slots[next].cell != none; next = (next + 1) & mask()) {
+                size_t want = home(slots[next].cell);
+                bool movable = hole <= next ? (want <= hole || want > next) : (want <= hole && want > next);
+                if (movable) {
+                    slots[hole] = slots[next];
+                    hole = next;
+                }
+            }
+            slots[hole] = Slot();
+            --count;
+        }
+
+        void grow() {
+            std::vector<Slot> old(slots.size() * 2);
+            old.swap(slots);
+            count = 0;
+            for (const Slot& slot : old) {
+                if (slot.cell != none) {
+                    insert(slot.cell, slot.agent);
+                }
+            }
+        }
+
+        void erase() {
+            if (count > 0) {
+                std::fill(slots.begin(), slots.end(), Slot());
+                count = 0;
+            }
+        }
+    };
+
+    std::vector<Layer> layers;
+    int base = 0;
+
+    Layer& layerFor(int time) { return layers[static_cast<size_t>(time) % layers.size()]; }
+    const Layer& layerFor(int time) const { return layers[static_cast<size_t>(time) % layers.size()]; }
+};
+
+#endif  // RESERVATIONTABLE_H
@@ -0,0 +1,165 @@
+#ifndef SEARCHSTATE_H
+#define SEARCHSTATE_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+
+// Per-cell bookkeeping of a grid search, stored in one contiguous array indexed
+// by cell (GridView::index) instead of hash maps keyed by Point.
+// Every cell carries the generation it was last written in, so reset() between
+// queries on the same grid size is O(1): stale cells simply read as unvisited.
+template <typename CostT>
+class BasicSearchState {
+public:
+    enum Status : uint8_t { Unvisited = 0, Open = 1, Closed = 2 };
+
+    static constexpr int noParent = -1;
+    static constexpr CostT unreached = std::numeric_limits<CostT>::max();
+
+    explicit BasicSearchState(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : cells(resource) {}
+
+    void reset(int cellCount) {
+        size_t count = static_cast<size_t>(cellCount);
+        if (cells.size() != count || ++generation == 0) {
+            // new grid size or stamp wrap-around: the only time cells are touched
+            cells.assign(count, Cell());
+            generation = 1;
+        }
+    }
+
+    int cellCount() const { return static_cast<int>(cells.size()); }
+
+    CostT g(int index) const { return isCurrent(index) ? cells[index].g : unreached; }
+    int parent(int index) const { return isCurrent(index) ? cells[index].parent : noParent; }
+    Status status(int index) const { return isCurrent(index) ? cells[index].status : Unvisited; }
+
+    void open(int index, CostT g, int parent) {
+        Cell& cell = cells[index];
+        cell.g = g;
+        cell.parent = parent;
+        cell.generation = generation;
+        cell.status = Open;
+    }
+
+    // index must have been opened in this generation
+    void close(int index) { cells[index].status = Closed; }
+
+private:
+    struct Cell {
+        CostT g = unreached;  // cost from start node
+        int parent = noParent;
+        uint32_t generation = 0;
+        Status status = Unvisited;
+    };
+
+    uint32_t generation = 0;
+    std::pmr::vector<Cell> cells;
+
+    bool isCurrent(int index) const { return cells[index].generation == generation; }
+};
+
+using SearchState = BasicSearchState<int>;
+
+// The same bookkeeping for maps too large for an entry per cell, such as a
+// paged TiledGrid: open addressing over the cells the search touched, so
+// memory follows the search instead of the map. Slower than SearchState, and
+// reset() costs the size of the largest search so far. Cells are 64-bit
+// indices (TiledGridView::index), so the map may have more than 2^31 cells.
+class SparseSearchState {
+public:
+    using Status = SearchState::Status;
+    using Index = int64_t;
+
+    static constexpr Index noParent = -1;
+    static constexpr int unreached = std::numeric_limits<int>::max();
+
+    explicit SparseSearchState(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : slots(resource) {}
+
+    void reset() {
+        if (used > 0) {
+            std::fill(slots.begin(), slots.end(), Slot());
+            used = 0;
+        }
+    }
+
+    size_t size() const { return used; }
+
+    int g(Index index) const {
+        const Slot* slot = find(index);
+        return slot != nullptr ? slot->g : unreached;
+    }
+    Index parent(Index index) const {
+        const Slot* slot = find(index);
+        return slot != nullptr ? slot->parent : noParent;
+    }
+    Status status(Index index) const {
+        const Slot* slot = find(index);
+        return slot != nullptr ? slot->status : SearchState::Unvisited;
+    }
+
+    void open(Index index, int g, Index parent) {
+        Slot& slot = insert(index);
+        slot.g = g;
+        slot.parent = parent;
+        slot.status = SearchState::Open;
+    }
+
+    // index must have been opened since the last reset
+    void close(Index index) { insert(index).status = SearchState::Closed; }
+
+private:
+    struct Slot {
+        Index index = -1;
+        Index parent = noParent;
+        int g = unreached;
+        Status status = SearchState::Unvisited;
+    };
+
+    std::pmr::vector<Slot> slots;
+    size_t used = 0;
+
+    // Fibonacci hashing: the high half of the product mixes every bit of index
+    size_t home(Index index) const { return static_cast<size_t>((static_cast<uint64_t>(index) * 0x9e3779b97f4a7c15ull) >> 32) & (slots.size() - 1); }
+
+    const Slot* find(Index index) const {
+        if (slots.empty()) {
+            return nullptr;
+        }
+        for (size_t i = home(index);; i = (i + 1) & (slots.size() - 1)) {
+            if (slots[i].index == index) {
+                return &slots[i];
+            }
+            if (slots[i].index == -1) {
+                return nullptr;
+            }
+        }
+    }
+
+    Slot& insert(Index index) {
+        if ((used + 1) * 2 > slots.size()) {
+            // at most half full, so probe runs stay short
+            std::pmr::vector<Slot> old(std::max<size_t>(slots.size() * 2, 1024), slots.get_allocator());
+            old.swap(slots);
+            used = 0;
+            for (const Slot& slot : old) {
+                if (slot.index != -1) {
+                    insert(slot.index) = slot;
+                }
+            }
+        }
+        size_t i = home(index);
+        while (slots[i].index != -1 && slots[i].index != index) {
+            i = (i + 1) & (slots.size() - 1);
+        }
+        if (slots[i].index == -1) {
+            slots[i].index = index;
+            ++used;
+        }
+        return slots[i];
+    }
+};
+
+#endif  // SEARCHSTATE_H
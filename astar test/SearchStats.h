@@ -0,0 +1,97 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include "GridStorage.h"
+
+// Define as 0 to compile the bookkeeping out of the search loops.
+#ifndef ASTAR_SEARCH_STATS
+#define ASTAR_SEARCH_STATS 1
+#endif
+#ifndef ASTAR_SEARCH_TRACE
+#define ASTAR_SEARCH_TRACE 1
+#endif
+
+constexpr bool searchStatsEnabled = ASTAR_SEARCH_STATS != 0;
+constexpr bool searchTraceEnabled = ASTAR_SEARCH_TRACE != 0;
+
+// What one query did. Stays all zero when ASTAR_SEARCH_STATS is 0.
+struct SearchStats {
+    int expanded = 0;      // cells taken off the open list
+    int pushed = 0;        // insertions and key improvements on the open list
+    int stalePops = 0;     // outdated entries skipped by open lists without decrease-key
+    int peakOpenSize = 0;
+    int reopenings = 0;    // cells expanded again after they had been closed
+    double micros = 0.0;   // wall-clock time of the whole query
+};
+
+// Called with every expanded cell, in expansion order.
+using SearchTrace = void (*)(void* user, const Point& cell);
+
+// Counters and trace hook shared by the searches. Every call is a constexpr
+// gated inline no-op when its switch is off, so disabled builds pay nothing.
+class SearchRecorder {
+public:
+    void setTrace(SearchTrace callback, void* user) {
+        trace = callback;
+        traceUser = user;
+    }
+
+    const SearchStats& stats() const { return current; }
+
+    void begin() {
+        if constexpr (searchStatsEnabled) {
+            current = SearchStats();
+            started = std::chrono::steady_clock::now();
+        }
+    }
+
+    void end() {
+        if constexpr (searchStatsEnabled) {
+            current.micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count();
+        }
+    }
+
+    // grid is a GridView or anything with its point(), e.g. a TiledGridView
+    // and its 64-bit indices
+    template <typename View, typename Index>
+    void expanded(const View& grid, Index index) {
+        if constexpr (searchStatsEnabled) {
+            ++current.expanded;
+        }
+        if constexpr (searchTraceEnabled) {
+            if (trace != nullptr) {
+                trace(traceUser, grid.point(index));
+            }
+        }
+    }
+
+    void pushed(size_t openSize) {
+        if constexpr (searchStatsEnabled) {
+            ++current.pushed;
+            current.peakOpenSize = std::max(current.peakOpenSize, static_cast<int>(openSize));
+        }
+    }
+
+    void stalePop() {
+        if constexpr (searchStatsEnabled) {
+            ++current.stalePops;
+        }
+    }
+
+    void reopened() {
+        if constexpr (searchStatsEnabled) {
+            ++current.reopenings;
+        }
+    }
+
+private:
+    SearchStats current;
+    SearchTrace trace = nullptr;
+    void* traceUser = nullptr;
+    std::chrono::steady_clock::time_point started;
+};
+
+#endif  // SEARCHSTATS_H
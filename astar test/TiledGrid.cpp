@@ -0,0 +1,184 @@
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include "TiledGrid.h"
+
+namespace {
+    const char tiledMagic[8] = { 'A', 'S', 'T', 'T', 'I', 'L', 'E', '\n' };
+    constexpr uint32_t tiledVersion = 1;
+    constexpr uint32_t tiledByteOrder = 0x01020304;
+    constexpr int minTileSize = 8;
+    constexpr int maxTileSize = 4096;
+    constexpr int minCachedTiles = 4;
+
+    struct TiledFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t rows;
+        uint32_t cols;
+        uint32_t tileSize;
+        uint32_t tileOffset;
+    };
+    static_assert(sizeof(TiledFileHeader) == 32, "the header layout is part of the file format");
+
+    bool isPowerOfTwo(uint32_t value) { return value != 0 && (value & (value - 1)) == 0; }
+
+    int log2(uint32_t value) {
+        int shift = 0;
+        while ((1u << shift) < value) {
+            ++shift;
+        }
+        return shift;
+    }
+}
+
+TiledGrid::TiledGrid(const std::string& filePath, size_t cacheBytes) : file(filePath, std::ios::binary), path(filePath) {
+    if (!file) {
+        throw std::runtime_error("Cannot open tiled grid file: " + path);
+    }
+
+    TiledFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, tiledMagic, sizeof(tiledMagic)) != 0
+        || header.version != tiledVersion || header.byteOrder != tiledByteOrder
+        || header.tileSize < minTileSize || header.tileSize > maxTileSize || !isPowerOfTwo(header.tileSize)
+        || header.tileOffset < sizeof(header)) {
+        throw std::runtime_error("Invalid tiled grid file: " + path);
+    }
+    // padded indices are 64-bit; the tile table is indexed by int
+    uint64_t tilesAcross = (static_cast<uint64_t>(header.cols) + header.tileSize - 1) / header.tileSize;
+    uint64_t tilesDown = (static_cast<uint64_t>(header.rows) + header.tileSize - 1) / header.tileSize;
+    if (header.rows == 0 || header.cols == 0 || header.rows > static_cast<uint32_t>(maxSide) || header.cols > static_cast<uint32_t>(maxSide)
+        || tilesAcross * tilesDown > INT_MAX) {
+        throw std::runtime_error("Invalid tiled grid file: " + path);
+    }
+
+    rows = static_cast<int>(header.rows);
+    cols = static_cast<int>(header.cols);
+    tile_shift = log2(header.tileSize);
+    tiles_across = (cols + tileSize() - 1) >> tile_shift;
+    tiles_down = (rows + tileSize() - 1) >> tile_shift;
+    tile_offset = header.tileOffset;
+
+    size_t tileBytes = static_cast<size_t>(tileSize()) * tileSize();
+    file.seekg(0, std::ios::end);
+    if (static_cast<uint64_t>(file.tellg()) < tile_offset + static_cast<uint64_t>(tileBytes) * tileCount()) {
+        throw std::runtime_error("Invalid tiled grid file: " + path);
+    }
+
+    size_t count = std::max<size_t>(cacheBytes / tileBytes, minCachedTiles);
+    count = std::min<size_t>(count, tileCount());
+    memory.assign(count * tileBytes, CELL_WALL);
+    slots.assign(count, Slot());
+    slot_of.assign(tileCount(), -1);
+}
+
+void TiledGrid::unlink(int slot) {
+    Slot& entry = slots[slot];
+    (entry.prev == -1 ? head : slots[entry.prev].next) = entry.next;
+    (entry.next == -1 ? tail : slots[entry.next].prev) = entry.prev;
+    entry.prev = -1;
+    entry.next = -1;
+}
+
+void TiledGrid::pushFront(int slot) {
+    slots[slot].next = head;
+    if (head != -1) {
+        slots[head].prev = slot;
+    }
+    head = slot;
+    if (tail == -1) {
+        tail = slot;
+    }
+}
+
+const uint8_t* TiledGrid::page(int tile) {
+    size_t tileBytes = static_cast<size_t>(tileSize()) * tileSize();
+
+    int slot = slot_of[tile];
+    if (slot != -1) {
+        ++stats.hits;
+        if (slot != head) {
+            unlink(slot);
+            pushFront(slot);
+        }
+        return &memory[slot * tileBytes];
+    }
+
+    // a free slot while there is one, else the least recently used tile
+    last_tile = -1;  // its slot may be the one reused
+    if (used < capacity()) {
+        slot = used++;
+    }
+    else {
+        slot = tail;
+        unlink(slot);
+        if (slots[slot].tile != -1) {
+            slot_of[slots[slot].tile] = -1;
+            ++stats.evictions;
+        }
+    }
+
+    uint8_t* data = &memory[slot * tileBytes];
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(tile_offset + static_cast<uint64_t>(tile) * tileBytes));
+    if (!file.read(reinterpret_cast<char*>(data), tileBytes)) {
+        // an empty slot at the back, the first to be reused
+        slots[slot].tile = -1;
+        slots[slot].prev = tail;
+        (tail == -1 ? head : slots[tail].next) = slot;
+        tail = slot;
+        throw std::runtime_error("Cannot read tiled grid file: " + path);
+    }
+    ++stats.pageIns;
+
+    slots[slot].tile = tile;
+    slot_of[tile] = slot;
+    pushFront(slot);
+    return data;
+}
+
+void TiledGrid::save(const std::string& path, const GridView& grid, int tileSize) {
+    if (tileSize < minTileSize || tileSize > maxTileSize || !isPowerOfTwo(static_cast<uint32_t>(tileSize))) {
+        throw std::invalid_argument("Tile size must be a power of two from 8 to 4096");
+    }
+    if (grid.empty()) {
+        throw std::runtime_error("Cannot save an empty grid: " + path);
+    }
+
+    TiledFileHeader header = {};
+    std::memcpy(header.magic, tiledMagic, sizeof(tiledMagic));
+    header.version = tiledVersion;
+    header.byteOrder = tiledByteOrder;
+    header.rows = static_cast<uint32_t>(grid.rows);
+    header.cols = static_cast<uint32_t>(grid.cols);
+    header.tileSize = static_cast<uint32_t>(tileSize);
+    header.tileOffset = sizeof(TiledFileHeader);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // one row of tiles at a time, so only that much is held in memory
+    int tilesAcross = (grid.cols + tileSize - 1) / tileSize;
+    size_t tileBytes = static_cast<size_t>(tileSize) * tileSize;
+    std::vector<uint8_t> band(tilesAcross * tileBytes);
+    for (int top = 0; top < grid.rows && out; top += tileSize) {
+        std::fill(band.begin(), band.end(), CELL_WALL);
+        for (int row = top; row < std::min(top + tileSize, grid.rows); ++row) {
+            for (int col = 0; col < grid.cols; ++col) {
+                band[(col / tileSize) * tileBytes + (row - top) * tileSize + col % tileSize] = grid.at(Point(row, col));
+            }
+        }
+        out.write(reinterpret_cast<const char*>(band.data()), band.size());
+    }
+    if (!out) {
+        throw std::runtime_error("Cannot write tiled grid file: " + path);
+    }
+}
+
+bool TiledGrid::isTiledFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(tiledMagic)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, tiledMagic, sizeof(tiledMagic)) == 0;
+}
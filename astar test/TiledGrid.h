@@ -0,0 +1,156 @@
+#ifndef TILEDGRID_H
+#define TILEDGRID_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "Point.h"
+#include "GridStorage.h"
+
+class TiledGrid;
+
+// Reads of a tile cache, for sizing it: every cell read is a hit unless its
+// tile had to be read from the file first.
+struct TileCacheStats {
+    unsigned long long hits = 0;
+    unsigned long long pageIns = 0;
+    unsigned long long evictions = 0;
+
+    double hitRate() const { return hits + pageIns == 0 ? 1.0 : static_cast<double>(hits) / (hits + pageIns); }
+};
+
+// GridView's interface over a TiledGrid, so the same search code runs on
+// either: padded indices with a wall border, only the border is computed
+// instead of stored. Indices are 64-bit, as a paged map may have more than
+// 2^31 cells. Reads page tiles in, so they are not thread-safe even though
+// they are const; the TiledGrid must outlive the view.
+struct TiledGridView {
+    using Index = int64_t;
+
+    TiledGrid* source = nullptr;
+    int rows = 0;
+    int cols = 0;
+    int stride = 0;  // cols + 2
+
+    bool empty() const { return rows == 0 || cols == 0; }
+    bool contains(const Point& p) const { return p.x >= 0 && p.x < rows && p.y >= 0 && p.y < cols; }
+
+    Index cellCount() const { return (static_cast<Index>(rows) + 2) * stride; }
+    Index index(const Point& p) const { return (static_cast<Index>(p.x) + 1) * stride + p.y + 1; }
+    Point point(Index index) const { return Point(static_cast<int>(index / stride) - 1, static_cast<int>(index % stride) - 1); }
+
+    inline uint8_t at(Index index) const;
+    uint8_t at(const Point& p) const { return at(index(p)); }
+    bool isWall(Index index) const { return at(index) == CELL_WALL; }
+    int cost(Index index) const { return cellCost(at(index)); }
+};
+
+// A map kept in a file of square tiles and paged in on demand through an LRU
+// cache of a fixed number of tiles, for maps larger than the memory a process
+// may use. Nearby cells share a tile, so a search that moves across the map
+// mostly reads tiles it already holds. Rows and cols may each go up to
+// maxSide, so (row, col) distances still fit an int, and the map may hold up
+// to INT_MAX tiles: with the default tile size that is some 8.8e12 cells.
+//
+// File (little-endian): a 32-byte header, then the tiles row by row, each
+// tileSize x tileSize cells row by row; cells past the map edge are walls.
+//   char     magic[8]      "ASTTILE\n"
+//   uint32_t version       1
+//   uint32_t byteOrder     0x01020304, as written by the saving machine
+//   uint32_t rows, cols
+//   uint32_t tileSize      a power of two from 8 to 4096
+//   uint32_t tileOffset    where the tiles start, 32
+class TiledGrid {
+public:
+    static constexpr int defaultTileSize = 64;
+    static constexpr int maxSide = 1 << 30;
+
+    TiledGrid() = default;
+    // Opens path with room for cacheBytes of tiles, at least four. Throws
+    // std::runtime_error if it cannot be opened or is not a valid tile file.
+    TiledGrid(const std::string& path, size_t cacheBytes);
+
+    // Views of a moved-from TiledGrid go stale.
+    TiledGrid(TiledGrid&&) = default;
+    TiledGrid& operator=(TiledGrid&&) = default;
+    TiledGrid(const TiledGrid&) = delete;
+    TiledGrid& operator=(const TiledGrid&) = delete;
+
+    // Writes grid as tiles. Throws std::invalid_argument for a bad tile size
+    // and std::runtime_error on failure.
+    static void save(const std::string& path, const GridView& grid, int tileSize = defaultTileSize);
+    // True if path starts with the tile file magic.
+    static bool isTiledFile(const std::string& path);
+
+    // Valid as long as this TiledGrid lives at the same address.
+    TiledGridView view() { return TiledGridView{ this, rows, cols, cols + 2 }; }
+    bool isOpen() const { return file.is_open(); }
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int tileSize() const { return 1 << tile_shift; }
+    int tileCount() const { return tiles_across * tiles_down; }
+    int capacity() const { return static_cast<int>(slots.size()); }
+    int cachedTiles() const { return used; }
+    size_t cacheBytes() const { return memory.size(); }
+
+    const TileCacheStats& statistics() const { return stats; }
+    void resetStatistics() { stats = TileCacheStats(); }
+
+    // Cell of the map, without the border; row and col must be inside it.
+    uint8_t cell(int row, int col) {
+        int tile = (row >> tile_shift) * tiles_across + (col >> tile_shift);
+        if (tile == last_tile) {
+            ++stats.hits;
+        }
+        else {
+            last_data = page(tile);
+            last_tile = tile;
+        }
+        int mask = (1 << tile_shift) - 1;
+        return last_data[((row & mask) << tile_shift) + (col & mask)];
+    }
+
+private:
+    // LRU list through the slots, most recently used first
+    struct Slot {
+        int tile = -1;
+        int prev = -1;
+        int next = -1;
+    };
+
+    std::ifstream file;
+    std::string path;
+    int rows = 0;
+    int cols = 0;
+    int tile_shift = 0;
+    int tiles_across = 0;
+    int tiles_down = 0;
+    uint32_t tile_offset = 0;
+
+    std::vector<uint8_t> memory;  // capacity() tiles
+    std::vector<Slot> slots;
+    std::vector<int> slot_of;     // per tile, -1 if not cached
+    int used = 0;
+    int head = -1;
+    int tail = -1;
+    int last_tile = -1;           // fast path: consecutive reads mostly stay in one tile
+    const uint8_t* last_data = nullptr;
+    TileCacheStats stats;
+
+    const uint8_t* page(int tile);
+    void unlink(int slot);
+    void pushFront(int slot);
+};
+
+uint8_t TiledGridView::at(Index index) const {
+    int row = static_cast<int>(index / stride) - 1;
+    int col = static_cast<int>(index % stride) - 1;
+    if (row < 0 || row >= rows || col < 0 || col >= cols) {
+        return CELL_WALL;  // the border
+    }
+    return source->cell(row, col);
+}
+
+#endif  // TILEDGRID_H
@@ -0,0 +1,86 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    for (unsigned i = 1; i < threadCount; ++i) {
+        threads.emplace_back(&WorkerPool::threadMain, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> guard(run_lock);
+        stopping = true;
+    }
+    run_start.notify_all();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::run(size_t count, const std::function<void(size_t item, unsigned worker)>& task) {
+    if (count == 0) {
+        return;
+    }
+    if (threads.empty() || count == 1) {
+        // nothing to share: skip the wake-up round trip
+        for (size_t item = 0; item < count; ++item) {
+            task(item, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(run_lock);
+        run_task = &task;
+        run_count = count;
+        next_item.store(0, std::memory_order_relaxed);
+        running = static_cast<unsigned>(threads.size());
+        ++run_id;
+    }
+    run_start.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> guard(run_lock);
+    run_done.wait(guard, [this] { return running == 0; });
+}
+
+void WorkerPool::threadMain(unsigned index) {
+    unsigned long long seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard(run_lock);
+            run_start.wait(guard, [this, seen] { return stopping || run_id != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = run_id;
+        }
+
+        work(index);
+
+        std::lock_guard<std::mutex> guard(run_lock);
+        if (--running == 0) {
+            run_done.notify_one();
+        }
+    }
+}
+
+void WorkerPool::work(unsigned index) {
+    while (true) {
+        size_t item = next_item.fetch_add(1, std::memory_order_relaxed);
+        if (item >= run_count) {
+            return;
+        }
+        (*run_task)(item, index);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+
+// Persistent threads for fork-join loops that run many times in a row (one
+// call per query batch or wavefront round), where starting threads each time
+// would cost more than the work. The calling thread takes part as worker 0.
+class WorkerPool {
+public:
+    // threadCount includes the calling thread; 0 picks one per hardware thread.
+    explicit WorkerPool(unsigned threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Calls task(item, worker) for every item in [0, count) and returns once
+    // all are done. Items are handed out one at a time, so uneven items
+    // balance themselves. Not reentrant.
+    void run(size_t count, const std::function<void(size_t item, unsigned worker)>& task);
+
+    unsigned threadCount() const { return static_cast<unsigned>(threads.size()) + 1; }
+
+private:
+    std::vector<std::thread> threads;
+
+    std::mutex run_lock;
+    std::condition_variable run_start;
+    std::condition_variable run_done;
+    unsigned long long run_id = 0;
+    unsigned running = 0;
+    bool stopping = false;
+
+    const std::function<void(size_t, unsigned)>* run_task = nullptr;
+    size_t run_count = 0;
+    std::atomic<size_t> next_item{ 0 };
+
+    void threadMain(unsigned index);
+    void work(unsigned index);
+};
+
+#endif  // WORKERPOOL_H
@@ -1,9 +1,16 @@
+#define NOMINMAX
 #include <Windows.h>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <chrono>
+#include <memory>
 #include "Game.h"
 #include "AStar.h"
+#include "PathService.h"
+#include "GridRenderer.h"
+#include "GridFile.h"
+#include "Maps.h"
 #include "args.hxx"
 
 constexpr int TARGET_FPS = 60;
@@ -18,11 +25,19 @@ constexpr int GAME_PATH = 4;
 LARGE_INTEGER lastFrameTime;
 Game game = Game(Grid(0, 0, 0, 0));
 
-COLORREF airColor = RGB(67, 65, 65); // gray
-COLORREF wallColor = RGB(255, 0, 0); 
-COLORREF startColor = RGB(44, 27, 107); // dark blue
-COLORREF finishColor = RGB(108, 71, 247); // light blue
-COLORREF pathColor = RGB(71, 247, 75); // lime green
+std::unique_ptr<GridRenderer> renderer; // the window only shows what it drew, see BlitRect
+std::wstring statusText;
+RECT statusRect = {}; // where statusText was last drawn
+
+std::vector<Point> explored; // cells expanded by the last search that ran
+enum class PathMode {
+    Async,    // searched on the path service's thread, drawn once published
+    Blocking, // 'B' toggles: LPA* inside the paint handler
+    Anytime,  // 'A' toggles: ARA* refined within each frame's budget
+};
+PathMode pathMode = PathMode::Async;
+bool refining = false; // the anytime path can still improve, so keep repainting
+std::unique_ptr<PathService> pathService; // owns its own copy of the grid, see SetCell
 
 bool ArePointsNotEqual(Point a, Point b)
 {
@@ -55,85 +70,157 @@ void DrawRectangle(HDC hdc, int x1, int y1, int x2, int y2, COLORREF color)
     DeleteObject(hBrush);
 }
 
-void DrawGrid(HDC hdc)
+GridRenderer::Palette MakePalette()
 {
-
-    for (int row = 0; row < game.grid.rows; ++row)
-    {
-        for (int col = 0; col < game.grid.cols; ++col)
-        {
-            int x1 = col * game.grid.size + col * game.grid.spacing;
-            int y1 = row * game.grid.size + row * game.grid.spacing;
-            int x2 = x1 + game.grid.size;
-            int y2 = y1 + game.grid.size;
-
-            int squareType = game.grid.getCell(row, col);;
-            switch (squareType) {
-
-            case (GAME_AIR): 
-                DrawRectangle(hdc, x1, y1, x2, y2, airColor);
-                break;
-            
-            case (GAME_WALL):
-                DrawRectangle(hdc, x1, y1, x2, y2, wallColor);
-                break;
-            
-            case (GAME_START): 
-                DrawRectangle(hdc, x1, y1, x2, y2, startColor);
-                break;
-
-            case (GAME_FINISH):
-                DrawRectangle(hdc, x1, y1, x2, y2, finishColor);
-                break;
-            
-            }
-        }
+    GridRenderer::Palette palette;
+    palette.cells.assign(256, palette.background);
+    palette.cells[GAME_AIR] = rgbColor(67, 65, 65); // gray
+    palette.cells[GAME_WALL] = rgbColor(255, 0, 0);
+    palette.cells[GAME_START] = rgbColor(44, 27, 107); // dark blue
+    palette.cells[GAME_FINISH] = rgbColor(108, 71, 247); // light blue
+    palette.path = rgbColor(71, 247, 75); // lime green
+    palette.explored = rgbColor(92, 88, 128); // grayish purple
+
+    // terrain from loaded maps gets darker the more it costs
+    for (int value = CELL_TERRAIN; value < 256; ++value) {
+        int dark = std::min(cellCost(static_cast<uint8_t>(value)) * 6, 60);
+        palette.cells[value] = rgbColor(140 - dark, 110 - dark, 70 - dark);
     }
+    return palette;
 }
 
-void DrawWay(HDC hdc) {
-    std::vector<Point> path = game.grid.findPath();
-    for (Point p : path) {
-        if (
-            ArePointsNotEqual(p, game.grid.start)
-            && ArePointsNotEqual(p, game.grid.finish)
-            ) 
-        {
-            // should be p.x * (...) and p.y * (...) but idk something is switched and it works that way
-            int x1 = p.y * (game.grid.size + game.grid.spacing);
-            int y1 = p.x * (game.grid.size + game.grid.spacing);
+// Copies part of the renderer's frame to the window.
+void BlitRect(HDC hdc, RECT rect)
+{
+    const FrameBuffer& frame = renderer->frame();
+    rect.left = std::max(rect.left, 0L);
+    rect.top = std::max(rect.top, 0L);
+    rect.right = std::min(rect.right, static_cast<LONG>(frame.width()));
+    rect.bottom = std::min(rect.bottom, static_cast<LONG>(frame.height()));
+    if (rect.left >= rect.right || rect.top >= rect.bottom) {
+        return;
+    }
 
-            int x2 = x1 + game.grid.size;
-            int y2 = y1 + game.grid.size;
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = frame.width();
+    info.bmiHeader.biHeight = -frame.height(); // top-down, like the frame
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    int width = rect.right - rect.left;
+    int height = rect.bottom - rect.top;
+    StretchDIBits(hdc, rect.left, rect.top, width, height, rect.left, rect.top, width, height,
+        frame.data(), &info, DIB_RGB_COLORS, SRCCOPY);
+}
 
-            DrawRectangle(hdc, x1, y1, x2, y2, pathColor);
-        }
-    }
+void DrawStatus(HDC hdc)
+{
+    // put back what the last, maybe longer, text covered
+    BlitRect(hdc, statusRect);
+    TextOut(hdc, 10, 10, statusText.c_str(), statusText.length());
+
+    SIZE extent;
+    GetTextExtentPoint32(hdc, statusText.c_str(), statusText.length(), &extent);
+    statusRect.left = 10;
+    statusRect.top = 10;
+    statusRect.right = 10 + extent.cx;
+    statusRect.bottom = 10 + extent.cy;
+}
 
-    std::wstring posString = L"Way length: " + std::to_wstring(path.size());
-    TextOut(hdc, 10, 10, posString.c_str(), posString.length());
+void TraceExpansion(void* user, const Point& cell) {
+    static_cast<std::vector<Point>*>(user)->push_back(cell);
 }
 
-bool GetMouseSquare(Point* point)
+// Every edit goes to the grid and to the path service's copy of it.
+void SetCell(int row, int col, int value)
 {
-    Point square;
-    square.x = game.mouse.pos.x / (game.grid.size + game.grid.spacing);
-    square.y = game.mouse.pos.y / (game.grid.size + game.grid.spacing);
+    game.grid.setCell(row, col, value);
+    if (pathService) {
+        pathService->setCell(row, col, static_cast<uint8_t>(value));
+    }
+}
 
-    float offsetX = game.mouse.pos.x % (game.grid.size + game.grid.spacing);
-    float offsetY = game.mouse.pos.y % (game.grid.size + game.grid.spacing);
+// Hands the current path and explored cells to the renderer and updates the status text.
+void UpdateWay() {
+    // a cached path expands nothing, so keep showing what the last real search explored
+    std::vector<Point> expanded;
+    std::vector<Point> path;
+    const SearchStats* stats;
+    double latency = 0.0;
+    unsigned long long misses = game.grid.getCacheMisses();
+    game.grid.setSearchTrace(TraceExpansion, &expanded);
+    if (pathMode == PathMode::Async) {
+        // whatever the service finished last, possibly a few edits behind;
+        // its expansions happen on another thread and are not shown
+        const PathResult& result = pathService->latest();
+        path = result.path;
+        stats = &result.stats;
+        latency = result.latencyMicros;
+        refining = false;
+        explored.clear();
+    }
+    else if (pathMode == PathMode::Anytime) {
+        // leave the rest of the frame for drawing
+        ARAStar::Budget budget;
+        budget.maxMillis = DESIRED_FRAME_TIME / 2;
+        const std::pmr::vector<Point>& found = game.grid.findPathAnytime(budget);
+        path.assign(found.begin(), found.end());
+        stats = &game.grid.getAnytimeSearch().lastStats();
+        refining = !game.grid.getAnytimeSearch().isFinished();
+        if (!expanded.empty()) {
+            explored.swap(expanded);
+        }
+    }
+    else {
+        const std::pmr::vector<Point>& found = game.grid.findPath();
+        path.assign(found.begin(), found.end());
+        stats = &game.grid.getSearchStats();
+        refining = false;
+        if (game.grid.getCacheMisses() != misses) {
+            explored.swap(expanded);
+        }
+    }
+    game.grid.setSearchTrace(nullptr);
 
-    if (offsetX >= game.grid.size || offsetY >= game.grid.size) {
-        // Mouse is over the spacing, not a valid square
-        return false;
+    // the renderer skips walls itself
+    std::vector<Point> overlay;
+    for (const Point& p : explored) {
+        if (ArePointsNotEqual(p, game.grid.start) && ArePointsNotEqual(p, game.grid.finish)) {
+            overlay.push_back(p);
+        }
     }
+    renderer->setExplored(overlay);
 
-    if (0 <= square.x && square.x < game.grid.cols && 0 <= square.y && square.y < game.grid.rows) {
-        *point = square;
-        return true;
+    overlay.clear();
+    for (const Point& p : path) {
+        if (ArePointsNotEqual(p, game.grid.start) && ArePointsNotEqual(p, game.grid.finish)) {
+            overlay.push_back(p);
+        }
+    }
+    renderer->setPath(overlay);
+
+    std::wstring posString = L"Way length: " + std::to_wstring(path.size())
+        + L"  expanded: " + std::to_wstring(stats->expanded)
+        + L"  pushed: " + std::to_wstring(stats->pushed)
+        + L"  peak open: " + std::to_wstring(stats->peakOpenSize)
+        + L"  reopened: " + std::to_wstring(stats->reopenings)
+        + L"  time: " + std::to_wstring(static_cast<int>(stats->micros)) + L" us";
+    if (pathMode == PathMode::Async) {
+        posString += L"  edit to path: " + std::to_wstring(static_cast<int>(latency)) + L" us";
+    }
+    if (pathMode == PathMode::Anytime && !path.empty()) {
+        // within this factor of the shortest way
+        std::wstring bound = std::to_wstring(game.grid.getAnytimeSearch().bound());
+        posString += L"  bound: " + bound.substr(0, bound.find(L'.') + 3);
     }
+    statusText = posString;
+}
 
-    return false;
+bool GetMouseSquare(Point* point)
+{
+    return game.grid.squareAt(game.mouse.pos.x, game.mouse.pos.y, *point);
 }
 
 
@@ -143,44 +230,65 @@ void GameUpdate()
     if (
         game.mouse.lButtonDown
         && GetMouseSquare(&curSquare)
-        && game.grid.getCell(curSquare.y, curSquare.x) != GAME_WALL
-        && ArePointsNotEqual(curSquare, game.grid.start)
-        && ArePointsNotEqual(curSquare, game.grid.finish)
+        && game.grid.getCell(curSquare.x, curSquare.y) != GAME_WALL
+        && !game.grid.isEndpoint(curSquare)
         ) {
-        game.grid.setCell(curSquare.y, curSquare.x, GAME_WALL);
+        SetCell(curSquare.x, curSquare.y, GAME_WALL);
         game.grid.changed = true;
     }
 
     if (
         game.mouse.rButtonDown
         && GetMouseSquare(&curSquare)
-        && game.grid.getCell(curSquare.y, curSquare.x) != GAME_AIR
-        && ArePointsNotEqual(curSquare, game.grid.start)
-        && ArePointsNotEqual(curSquare, game.grid.finish)
+        && game.grid.getCell(curSquare.x, curSquare.y) != GAME_AIR
+        && !game.grid.isEndpoint(curSquare)
         ) {
-        game.grid.setCell(curSquare.y, curSquare.x, GAME_AIR);
+        SetCell(curSquare.x, curSquare.y, GAME_AIR);
         game.grid.changed = true;
     }
 }
 
-void GameRender(HWND hwnd)
+// Repaints edited cells and path changes, and copies only those to the window.
+void GameRender(HDC hdc)
 {
-    //TODO: only render updated regions
-    PAINTSTRUCT ps;
-    HDC hdc = BeginPaint(hwnd, &ps);
-
+    for (const Point& p : game.grid.takeRedrawLog()) {
+        renderer->cellChanged(p.x, p.y);
+    }
 
+    std::wstring shownStatus = statusText;
     if (game.grid.changed) {
-        DrawGrid(hdc);
-        DrawWay(hdc);
+        UpdateWay();
+    }
+    game.grid.changed = refining;
+
+    const std::vector<PixelRect>& damage = renderer->render(game.grid.view());
+    for (const PixelRect& rect : damage) {
+        BlitRect(hdc, RECT{ rect.left, rect.top, rect.right, rect.bottom });
+    }
+    // the copies may have covered the text
+    if (!damage.empty() || statusText != shownStatus) {
+        DrawStatus(hdc);
     }
-    game.grid.changed = false;
 
     /*std::wstring posString = L"Mouse position: (" + std::to_wstring(game.mouse.pos.x) + L", " + std::to_wstring(game.mouse.pos.y) + L")";
     TextOut(hdc, 10, 10, posString.c_str(), posString.length());*/
+}
 
-    EndPaint(hwnd, &ps);
-    ReleaseDC(hwnd, hdc);
+// The window lost part of its content (uncovered, resized): copy it back from
+// the frame, nothing is redrawn.
+void GameRepaint(HDC hdc, const RECT& area)
+{
+    const FrameBuffer& frame = renderer->frame();
+    BlitRect(hdc, area);
+
+    // beyond the grid stays white
+    if (area.right > frame.width()) {
+        DrawRectangle(hdc, std::max(area.left, static_cast<LONG>(frame.width())), area.top, area.right, area.bottom, RGB(255, 255, 255));
+    }
+    if (area.bottom > frame.height()) {
+        DrawRectangle(hdc, area.left, std::max(area.top, static_cast<LONG>(frame.height())), area.right, area.bottom, RGB(255, 255, 255));
+    }
+    DrawStatus(hdc);
 }
 
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
@@ -283,19 +391,8 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
     }
     
     case WM_SIZE: {
-        // on resize paint everything white
-        int width = LOWORD(lParam);
-        int height = HIWORD(lParam);
-
-        PAINTSTRUCT ps;
-        HDC hdc = BeginPaint(hwnd, &ps);
-
-        DrawRectangle(hdc, 0, 0, width, height, RGB(255, 255, 255));
-        game.grid.changed = true;
-
-        EndPaint(hwnd, &ps);
-        ReleaseDC(hwnd, hdc);
-
+        // the frame is still current, WM_PAINT just copies it again
+        InvalidateRect(hwnd, NULL, FALSE);
         return 0;
     }
 
@@ -311,6 +408,13 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
     }
 
     case WM_KEYDOWN: {
+        if ((wParam == 'A' || wParam == 'B') && GetForegroundWindow() == hwnd)
+        {
+            PathMode toggled = wParam == 'A' ? PathMode::Anytime : PathMode::Blocking;
+            pathMode = pathMode == toggled ? PathMode::Async : toggled;
+            game.grid.changed = true;
+        }
+
         if (wParam == 'C')
         {
             // Check if the window is in the foreground
@@ -322,7 +426,7 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                     for (int col = 0; col < game.grid.cols; ++col)
                     {
                         if (game.grid.getCell(row, col) == GAME_WALL) {
-                            game.grid.setCell(row, col, GAME_AIR);
+                            SetCell(row, col, GAME_AIR);
                         }
                     }
                 }
@@ -333,7 +437,10 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
     }
 
     case WM_PAINT: {
-        GameRender(hwnd);
+        PAINTSTRUCT ps;
+        HDC hdc = BeginPaint(hwnd, &ps);
+        GameRepaint(hdc, ps.rcPaint);
+        EndPaint(hwnd, &ps);
         return 0;
     }
 
@@ -380,12 +487,20 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
     while (true)
     {
-        // windows events
-        // only process if not wm paint because wm paint gets triggered later at 60fps
-        if (GetMessage(&msg, NULL, 0, 0) && msg.message != WM_PAINT) {
+        // windows events; WM_PAINT only copies the frame back, the frames
+        // themselves are drawn below at 60fps
+        bool quit = false;
+        while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+            if (msg.message == WM_QUIT) {
+                quit = true;
+                break;
+            }
             TranslateMessage(&msg);
             DispatchMessage(&msg);
         }
+        if (quit) {
+            break;
+        }
 
         if (GetAsyncKeyState(VK_LBUTTON) & 0x8000)
         {
@@ -409,10 +524,13 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
             lastFrameTime.QuadPart += static_cast<LONGLONG>(elapsed / DESIRED_FRAME_TIME) * static_cast<LONGLONG>(DESIRED_FRAME_TIME);
 
             GameUpdate();
-            InvalidateRect(hwnd, NULL, TRUE);
+            if (pathMode == PathMode::Async && pathService->hasNewResult()) {
+                game.grid.changed = true;
+            }
 
-            // Optional: Force an immediate repaint of the invalidated region
-            UpdateWindow(hwnd);
+            HDC hdc = GetDC(hwnd);
+            GameRender(hdc);
+            ReleaseDC(hwnd, hdc);
         }
         else
         {
@@ -434,6 +552,7 @@ int main(int argc, char* argv[])
     args::ValueFlag<int> cols(parser, "cols", "Number of columns (default: 10)", { 'c', "cols" });
     args::ValueFlag<int> size(parser, "size", "Size of each element (default: 50)", { 's', "size" });
     args::ValueFlag<int> spacing(parser, "spacing", "Spacing between elements (default: 2)", { 'p', "spacing" });
+    args::ValueFlag<std::string> mapFile(parser, "file", "Start from a MovingAI .map or a binary grid file instead of an empty grid", { 'f', "file" });
 
     try {
         parser.ParseCLI(argc, argv);
@@ -461,18 +580,40 @@ int main(int argc, char* argv[])
     std::cout << "Spacing between elements: " << elementSpacing << std::endl;
 
 
-    Grid grid = Grid(numRows, numCols, elementSize, elementSpacing);
-    game = Game(grid);
+    if (mapFile) {
+        // the app edits its grid, so even a mapped file is copied once
+        try {
+            if (GridFile::isGridFile(*mapFile)) {
+                game = Game(Grid(GridFile(*mapFile).view(), elementSize, elementSpacing));
+            }
+            else {
+                game = Game(Grid(loadMovingAIMap(*mapFile).view(), elementSize, elementSpacing));
+            }
+        }
+        catch (std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Loaded " << *mapFile << ": " << game.grid.rows << "x" << game.grid.cols << std::endl;
+    }
+    else {
+        Grid grid = Grid(numRows, numCols, elementSize, elementSpacing);
+        game = Game(grid);
 
-    for (int row = 0; row < game.grid.rows; ++row)
-    {
-        for (int col = 0; col < game.grid.cols; ++col)
+        for (int row = 0; row < game.grid.rows; ++row)
         {
-            game.grid.setCell(row, col, GAME_AIR);
+            for (int col = 0; col < game.grid.cols; ++col)
+            {
+                game.grid.setCell(row, col, GAME_AIR);
+            }
         }
     }
-    game.grid.setCell(0, 0, GAME_START);
-    game.grid.setCell(game.grid.rows-1, game.grid.cols-1, GAME_FINISH);
+    game.grid.setCell(game.grid.start.x, game.grid.start.y, GAME_START);
+    game.grid.setCell(game.grid.finish.x, game.grid.finish.y, GAME_FINISH);
+
+    pathService = std::make_unique<PathService>(game.grid.view());
+    renderer = std::make_unique<GridRenderer>(game.grid.rows, game.grid.cols, elementSize, elementSpacing, MakePalette());
+    pathService->setEndpoints(game.grid.start, game.grid.finish);
 
     
     // hide cmd
@@ -0,0 +1,112 @@
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "Check.h"
+#include "ARAStar.h"
+#include "Maps.h"
+
+namespace {
+
+// Cheapest cost from start to goal, paid on entering each cell after the
+// start; -1 if the goal cannot be reached.
+int referenceCost(const GridView& grid, const Point& start, const Point& goal) {
+    using Entry = std::pair<int, int>;  // cost, cell
+    std::vector<int> cost(grid.cellCount(), -1);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    cost[grid.index(start)] = 0;
+    open.push({ 0, grid.index(start) });
+    const int offsets[] = { 1, -1, grid.stride, -grid.stride };
+    while (!open.empty()) {
+        Entry top = open.top();
+        open.pop();
+        if (top.first != cost[top.second]) {
+            continue;
+        }
+        for (int offset : offsets) {
+            int next = top.second + offset;
+            int entered = top.first + grid.cost(next);
+            if (!grid.isWall(next) && (cost[next] < 0 || entered < cost[next])) {
+                cost[next] = entered;
+                open.push({ entered, next });
+            }
+        }
+    }
+    return cost[grid.index(goal)];
+}
+
+// Terrain cost of the cells after the first, or -1 unless path walks from
+// start to goal over free, 4-adjacent cells.
+int walkedCost(const GridView& grid, const std::pmr::vector<Point>& path, const Point& start, const Point& goal) {
+    if (path.empty() || !(path.front() == start) || !(path.back() == goal)) {
+        return -1;
+    }
+    int cost = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (!grid.contains(path[i]) || grid.isWall(grid.index(path[i]))
+            || std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y) != 1) {
+            return -1;
+        }
+        cost += grid.cost(grid.index(path[i]));
+    }
+    return cost;
+}
+
+}  // namespace
+
+// Stopped after any number of expansions, the path so far must walk and cost
+// at most bound() times the optimum; once isFinished() it must be optimal,
+// or absent where there is none.
+TEST(araStarStaysWithinItsBound) {
+    const MapKind kinds[] = { MapKind::Terrain, MapKind::Rooms, MapKind::Maze, MapKind::Random };
+    const double weights[][2] = { { 3.0, 0.5 }, { 5.0, 1.5 }, { 1.5, 0.1 } };
+    for (int map = 0; map < 4; ++map) {
+        GridStorage storage = generateMap(kinds[map], 40, 55, 210 + map, 0.3);
+        GridView grid = storage.view();
+        std::mt19937 rng(220 + map);
+
+        size_t outOfBound = 0;
+        size_t broken = 0;
+        size_t notOptimal = 0;
+        size_t unfinished = 0;
+        for (int query = 0; query < 12; ++query) {
+            Point start(rng() % grid.rows, rng() % grid.cols);
+            Point goal(rng() % grid.rows, rng() % grid.cols);
+            storage.set(start.x, start.y, 0);
+            int optimum = referenceCost(grid, start, goal);
+
+            for (const auto& weight : weights) {
+                for (int expansions : { 1, 3, 17 }) {
+                    ARAStar search(weight[0], weight[1]);
+                    ARAStar::Budget budget;
+                    budget.maxExpansions = expansions;
+                    int calls = 0;
+                    do {
+                        const std::pmr::vector<Point>& path = search.findPath(grid, start, goal, budget);
+                        if (!path.empty()) {
+                            int cost = walkedCost(grid, path, start, goal);
+                            broken += cost >= 0 && cost == search.lastCost() ? 0 : 1;
+                            outOfBound += optimum >= 0 && search.bound() >= 1.0
+                                && search.lastCost() <= search.bound() * optimum + 1e-9 ? 0 : 1;
+                        }
+                    } while (!search.isFinished() && ++calls < 1000000);
+
+                    unfinished += search.isFinished() ? 0 : 1;
+                    const std::pmr::vector<Point>& path = search.findPath(grid, start, goal, budget);
+                    if (optimum < 0) {
+                        notOptimal += path.empty() ? 0 : 1;
+                    }
+                    else {
+                        notOptimal += walkedCost(grid, path, start, goal) == optimum && search.bound() == 1.0 ? 0 : 1;
+                    }
+                }
+            }
+        }
+        CHECK(unfinished == 0);
+        CHECK(broken == 0);
+        CHECK(outOfBound == 0);
+        CHECK(notOptimal == 0);
+    }
+}
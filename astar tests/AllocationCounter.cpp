@@ -0,0 +1,49 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include "AllocationCounter.h"
+
+static std::atomic<long long> allocations{ 0 };
+
+long long allocationCount() {
+    return allocations.load();
+}
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++allocations;
+    size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    void* p = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    void* p = std::aligned_alloc(align, (size + align - 1) / align * align + (size == 0 ? align : 0));
+#endif
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept { operator delete(p, alignment); }
@@ -0,0 +1,11 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+// The test executable replaces the global operator new and delete, so every
+// allocation of the process is counted, on any thread. SearchContext
+// allocates through std::pmr::new_delete_resource, which uses the aligned
+// forms. The replacements live in their own file so the compiler cannot
+// inline them into code that checks new/delete pairs.
+long long allocationCount();
+
+#endif  // ALLOCATIONCOUNTER_H
@@ -0,0 +1,74 @@
+#include <random>
+#include <vector>
+#include "AllocationCounter.h"
+#include "Check.h"
+#include "AStar.h"
+#include "Maps.h"
+
+namespace {
+
+struct Query {
+    Point start;
+    Point goal;
+};
+
+std::vector<Query> randomQueries(const GridView& grid, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<Query> queries;
+    while (static_cast<int>(queries.size()) < count) {
+        Point start(rng() % grid.rows, rng() % grid.cols);
+        Point goal(rng() % grid.rows, rng() % grid.cols);
+        if (!grid.isWall(grid.index(start)) && !grid.isWall(grid.index(goal))) {
+            queries.push_back({ start, goal });
+        }
+    }
+    return queries;
+}
+
+// Runs the queries once to size the context, then again counting allocations.
+long long steadyStateAllocations(const GridView& grid, const std::vector<Query>& queries, SearchMode mode, const Landmarks* landmarks = nullptr) {
+    AStar path_finder;
+    AStar::SearchContext context;
+    context.setLandmarks(landmarks);
+    for (const Query& query : queries) {
+        path_finder.findPath(context, grid, query.start, query.goal, mode);
+    }
+
+    long long before = allocationCount();
+    size_t found = 0;
+    for (int round = 0; round < 3; ++round) {
+        for (const Query& query : queries) {
+            found += path_finder.findPath(context, grid, query.start, query.goal, mode).empty() ? 0 : 1;
+        }
+    }
+    long long allocations = allocationCount() - before;
+    CHECK(found > 0);
+    return allocations;
+}
+
+}  // namespace
+
+TEST(searchContextIsAllocationFree) {
+    GridStorage rooms = generateMap(MapKind::Rooms, 120, 90, 3);
+    GridStorage terrain = generateMap(MapKind::Terrain, 100, 100, 4);
+    std::vector<Query> roomQueries = randomQueries(rooms.view(), 50, 5);
+    std::vector<Query> terrainQueries = randomQueries(terrain.view(), 50, 6);
+
+    CHECK(steadyStateAllocations(rooms.view(), roomQueries, SearchMode::Standard) == 0);
+    CHECK(steadyStateAllocations(rooms.view(), roomQueries, SearchMode::JumpPoint) == 0);
+    CHECK(steadyStateAllocations(rooms.view(), roomQueries, SearchMode::Bidirectional) == 0);
+    CHECK(steadyStateAllocations(terrain.view(), terrainQueries, SearchMode::Weighted) == 0);
+
+    Landmarks landmarks(8);
+    landmarks.build(rooms.view());
+    CHECK(steadyStateAllocations(rooms.view(), roomQueries, SearchMode::Landmark, &landmarks) == 0);
+}
+
+// The counter itself: a query without a context allocates its own buffers.
+TEST(allocationsAreCounted) {
+    GridStorage grid(20, 20);
+    AStar path_finder;
+    long long before = allocationCount();
+    CHECK(!path_finder.findPath(grid.view(), Point(0, 0), Point(19, 19)).empty());
+    CHECK(allocationCount() > before);
+}
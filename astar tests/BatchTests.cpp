@@ -0,0 +1,77 @@
+#include <random>
+#include <vector>
+#include "Check.h"
+#include "AStar.h"
+#include "BatchPathFinder.h"
+#include "Maps.h"
+
+namespace {
+
+std::vector<PathQuery> mixedQueries(const GridView& grid, int count, unsigned seed) {
+    const SearchMode modes[] = { SearchMode::Standard, SearchMode::JumpPoint, SearchMode::Bidirectional, SearchMode::Weighted, SearchMode::Landmark };
+    std::mt19937 rng(seed);
+    std::vector<PathQuery> queries;
+    for (int i = 0; i < count; ++i) {
+        PathQuery query;
+        // walls too: those queries must come back empty on every thread
+        query.start = Point(rng() % grid.rows, rng() % grid.cols);
+        query.goal = Point(rng() % grid.rows, rng() % grid.cols);
+        query.mode = modes[rng() % 5];
+        queries.push_back(query);
+    }
+    return queries;
+}
+
+}  // namespace
+
+// Every thread count must give exactly the paths of one AStar run per query on
+// the calling thread, batch after batch with the same contexts.
+TEST(batchMatchesSequentialSearch) {
+    const MapKind kinds[] = { MapKind::Rooms, MapKind::Maze, MapKind::Terrain };
+    for (int map = 0; map < 3; ++map) {
+        GridStorage storage = generateMap(kinds[map], 90, 110, 20 + map);
+        GridView grid = storage.view();
+        Landmarks landmarks(6);
+        landmarks.build(grid);
+
+        AStar path_finder;
+        AStar::SearchContext context;
+        context.setLandmarks(&landmarks);
+        std::vector<std::vector<PathQuery>> batches;
+        std::vector<std::vector<std::vector<Point>>> expected;
+        for (unsigned seed = 0; seed < 3; ++seed) {
+            batches.push_back(mixedQueries(grid, 300, seed + 10 * map));
+            expected.emplace_back();
+            for (const PathQuery& query : batches.back()) {
+                const std::pmr::vector<Point>& path = path_finder.findPath(context, grid, query.start, query.goal, query.mode);
+                expected.back().emplace_back(path.begin(), path.end());
+            }
+        }
+
+        for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+            BatchPathFinder batch(threads);
+            batch.setLandmarks(&landmarks);
+            CHECK(batch.threadCount() == threads);
+            for (size_t i = 0; i < batches.size(); ++i) {
+                std::vector<std::vector<Point>> results = batch.findPaths(grid, batches[i]);
+                CHECK(results.size() == expected[i].size());
+                size_t mismatches = 0;
+                for (size_t q = 0; q < results.size() && q < expected[i].size(); ++q) {
+                    mismatches += results[q] == expected[i][q] ? 0 : 1;
+                }
+                CHECK(mismatches == 0);
+            }
+        }
+    }
+}
+
+TEST(batchHandlesEmptyAndTinyBatches) {
+    GridStorage storage(10, 10);
+    BatchPathFinder batch(4);
+    CHECK(batch.findPaths(storage.view(), {}).empty());
+
+    std::vector<PathQuery> one(1);
+    one[0].goal = Point(9, 9);
+    std::vector<std::vector<Point>> results = batch.findPaths(storage.view(), one);
+    CHECK(results.size() == 1 && results[0].size() == 19);
+}
@@ -0,0 +1,41 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdio>
+#include <vector>
+
+// Just enough of a test framework for these tests: TEST(name) registers a
+// function, CHECK records a failure and goes on, so one run reports them all.
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<TestCase>& testCases() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+struct TestRegistrar {
+    TestRegistrar(const char* name, void (*run)()) { testCases().push_back({ name, run }); }
+};
+
+#define TEST(name) \
+    static void name(); \
+    static TestRegistrar name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            ++checkFailures(); \
+            std::printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+        } \
+    } while (false)
+
+#endif  // CHECK_H
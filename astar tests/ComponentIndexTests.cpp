@@ -0,0 +1,126 @@
+#include <random>
+#include <vector>
+#include "Check.h"
+#include "ComponentIndex.h"
+#include "Maps.h"
+
+namespace {
+
+// BFS labels per padded cell, -1 for walls; count gets the number of components.
+std::vector<int> referenceLabels(const GridView& grid, int& count) {
+    std::vector<int> label(grid.cellCount(), -1);
+    std::vector<int> queue;
+    count = 0;
+    for (int row = 0; row < grid.rows; ++row) {
+        for (int col = 0; col < grid.cols; ++col) {
+            int cell = grid.index(Point(row, col));
+            if (grid.isWall(cell) || label[cell] != -1) {
+                continue;
+            }
+            queue.assign(1, cell);
+            label[cell] = count;
+            for (size_t head = 0; head < queue.size(); ++head) {
+                for (int offset : { 1, -1, grid.stride, -grid.stride }) {
+                    int next = queue[head] + offset;
+                    if (!grid.isWall(next) && label[next] == -1) {
+                        label[next] = count;
+                        queue.push_back(next);
+                    }
+                }
+            }
+            ++count;
+        }
+    }
+    return label;
+}
+
+// Pairs where connected() disagrees with BFS, plus one if the component
+// counts differ: random pairs, and the edited cell and its neighbors against
+// random cells, where a split or merge shows first.
+size_t disagreements(ComponentIndex& index, const GridView& grid, const Point& edited, std::mt19937& rng) {
+    int count = 0;
+    std::vector<int> label = referenceLabels(grid, count);
+    size_t wrong = index.componentCount() == count ? 0 : 1;
+
+    auto agrees = [&](const Point& a, const Point& b) {
+        if (!grid.contains(a) || !grid.contains(b)) {
+            return true;
+        }
+        int la = label[grid.index(a)];
+        int lb = label[grid.index(b)];
+        return index.connected(grid, a, b) == (la != -1 && la == lb);
+    };
+    const Point near[] = { edited, Point(edited.x - 1, edited.y), Point(edited.x + 1, edited.y),
+        Point(edited.x, edited.y - 1), Point(edited.x, edited.y + 1) };
+    for (int i = 0; i < 30; ++i) {
+        Point a(rng() % grid.rows, rng() % grid.cols);
+        Point b(rng() % grid.rows, rng() % grid.cols);
+        wrong += agrees(a, b) ? 0 : 1;
+        wrong += agrees(near[i % 5], b) ? 0 : 1;
+        wrong += agrees(near[i % 5], near[(i + 1 + i / 5) % 5]) ? 0 : 1;
+    }
+    return wrong;
+}
+
+}  // namespace
+
+// Random walls placed and removed one at a time must leave the index
+// answering like a BFS of the current grid, component count included.
+TEST(componentIndexMatchesBfs) {
+    const int rows = 40;
+    const int cols = 50;
+    const MapKind kinds[] = { MapKind::Random, MapKind::Rooms, MapKind::Maze };
+    for (int map = 0; map < 3; ++map) {
+        GridStorage storage = generateMap(kinds[map], rows, cols, 140 + map, 0.35);
+        ComponentIndex index;
+        index.build(storage.view());
+        std::mt19937 rng(150 + map);
+        size_t wrong = disagreements(index, storage.view(), Point(0, 0), rng);
+
+        for (int edit = 0; edit < 800; ++edit) {
+            Point p(rng() % rows, rng() % cols);
+            if (storage.get(p.x, p.y) == CELL_WALL) {
+                storage.set(p.x, p.y, rng() % 2 == 0 ? 0 : terrainCell(3));
+                index.cellOpened(storage.view(), p.x, p.y);
+            }
+            else {
+                storage.set(p.x, p.y, CELL_WALL);
+                index.cellBlocked(storage.view(), p.x, p.y);
+            }
+            wrong += disagreements(index, storage.view(), p, rng);
+        }
+        CHECK(wrong == 0);
+    }
+}
+
+// The app's 'C' key opens every wall in row-major order, one cellOpened each.
+TEST(componentIndexClearAll) {
+    const int rows = 40;
+    const int cols = 50;
+    GridStorage storage = generateMap(MapKind::Maze, rows, cols, 160);
+    ComponentIndex index;
+    index.build(storage.view());
+    // blocks on top of the maze first, so some walls seal cells off
+    std::mt19937 rng(161);
+    for (int edit = 0; edit < 300; ++edit) {
+        Point p(rng() % rows, rng() % cols);
+        if (storage.get(p.x, p.y) != CELL_WALL) {
+            storage.set(p.x, p.y, CELL_WALL);
+            index.cellBlocked(storage.view(), p.x, p.y);
+        }
+    }
+
+    size_t wrong = 0;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            if (storage.get(row, col) == CELL_WALL) {
+                storage.set(row, col, 0);
+                index.cellOpened(storage.view(), row, col);
+                wrong += disagreements(index, storage.view(), Point(row, col), rng);
+            }
+        }
+    }
+    CHECK(wrong == 0);
+    CHECK(index.componentCount() == 1);
+    CHECK(index.connected(storage.view(), Point(0, 0), Point(rows - 1, cols - 1)));
+}
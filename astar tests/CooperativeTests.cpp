@@ -0,0 +1,79 @@
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "Check.h"
+#include "CooperativePlanner.h"
+#include "Maps.h"
+
+namespace {
+
+// count distinct free cells, none of them in avoid
+std::vector<Point> freeCells(const GridView& grid, size_t count, std::mt19937& rng, const std::vector<Point>& avoid = {}) {
+    std::set<std::pair<int, int>> taken;
+    for (const Point& p : avoid) {
+        taken.insert({ p.x, p.y });
+    }
+    std::vector<Point> cells;
+    while (cells.size() < count) {
+        Point p(rng() % grid.rows, rng() % grid.cols);
+        if (!grid.isWall(grid.index(p)) && taken.insert({ p.x, p.y }).second) {
+            cells.push_back(p);
+        }
+    }
+    return cells;
+}
+
+}  // namespace
+
+// Whatever the window and replanning interval, every step must move each
+// agent at most one cell onto free floor, and no two agents may share a
+// cell or trade places.
+TEST(cooperativeAgentsNeverCollide) {
+    const MapKind kinds[] = { MapKind::Open, MapKind::Rooms, MapKind::Random };
+    for (int map = 0; map < 3; ++map) {
+        GridStorage storage = generateMap(kinds[map], 24, 32, 230 + map);
+        GridView grid = storage.view();
+        std::mt19937 rng(240 + map);
+        std::vector<Point> starts = freeCells(grid, 30, rng);
+        // goals may be other agents' starts: they have to get out of the way
+        std::vector<Point> goals = freeCells(grid, 30, rng, std::vector<Point>(starts.begin(), starts.begin() + 20));
+
+        size_t shared = 0;
+        size_t swapped = 0;
+        size_t badMoves = 0;
+        size_t runs = 0;
+        size_t home = 0;
+        for (int window = 1; window <= 16; ++window) {
+            for (int replanInterval : { 0, 1, 2, 5, 16, 40 }) {
+                CooperativePlanner planner(window, replanInterval);
+                planner.reset(grid, starts, goals);
+                std::vector<Point> before = planner.positions();
+                for (int step = 0; step < 150 && !planner.allArrived(); ++step) {
+                    planner.step();
+                    const std::vector<Point>& after = planner.positions();
+                    std::set<std::pair<int, int>> occupied;
+                    for (size_t a = 0; a < after.size(); ++a) {
+                        shared += occupied.insert({ after[a].x, after[a].y }).second ? 0 : 1;
+                        int moved = std::abs(after[a].x - before[a].x) + std::abs(after[a].y - before[a].y);
+                        badMoves += moved <= 1 && !grid.isWall(grid.index(after[a])) ? 0 : 1;
+                        for (size_t b = a + 1; b < after.size(); ++b) {
+                            swapped += after[a] == before[b] && after[b] == before[a] ? 1 : 0;
+                        }
+                    }
+                    before = after;
+                }
+                ++runs;
+                for (size_t a = 0; a < planner.agentCount(); ++a) {
+                    home += planner.arrivalTime(static_cast<int>(a)) >= 0 ? 1 : 0;
+                }
+            }
+        }
+        CHECK(shared == 0);
+        CHECK(swapped == 0);
+        CHECK(badMoves == 0);
+        // agents that never move never collide: most must get home
+        CHECK(home * 2 > runs * starts.size());
+    }
+}
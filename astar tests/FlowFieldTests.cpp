@@ -0,0 +1,144 @@
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "Check.h"
+#include "FlowField.h"
+#include "Game.h"
+#include "Maps.h"
+
+namespace {
+
+// Dijkstra backwards from the goal: stepping onto a cell costs that cell.
+std::vector<int> referenceDistances(const GridView& grid, const Point& goal) {
+    using Entry = std::pair<int, int>;  // distance, cell
+    std::vector<int> dist(grid.cellCount(), FlowField::unreachable);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    int goalIndex = grid.index(goal);
+    if (!grid.isWall(goalIndex)) {
+        dist[goalIndex] = 0;
+        open.push({ 0, goalIndex });
+    }
+    const int offsets[] = { 1, -1, grid.stride, -grid.stride };
+    while (!open.empty()) {
+        Entry top = open.top();
+        open.pop();
+        if (top.first != dist[top.second]) {
+            continue;
+        }
+        int entered = top.first + grid.cost(top.second);
+        for (int offset : offsets) {
+            int next = top.second + offset;
+            if (!grid.isWall(next) && entered < dist[next]) {
+                dist[next] = entered;
+                open.push({ entered, next });
+            }
+        }
+    }
+    return dist;
+}
+
+// Cells whose distance differs from the reference, or whose step does not
+// lead to a neighbor exactly its own cost closer to the goal.
+size_t wrongCells(const FlowField& field, const GridView& grid, const Point& goal) {
+    std::vector<int> expected = referenceDistances(grid, goal);
+    size_t wrong = 0;
+    for (int row = 0; row < grid.rows; ++row) {
+        for (int col = 0; col < grid.cols; ++col) {
+            Point p(row, col);
+            int distance = field.distance(p);
+            Point next;
+            bool moves = field.nextStep(p, next);
+            bool ok = distance == expected[grid.index(p)];
+            if (distance == FlowField::unreachable || p == goal) {
+                ok = ok && !moves;
+            }
+            else {
+                ok = ok && moves && std::abs(next.x - p.x) + std::abs(next.y - p.y) == 1
+                    && field.distance(next) + grid.cost(grid.index(next)) == distance;
+            }
+            wrong += ok ? 0 : 1;
+        }
+    }
+    return wrong;
+}
+
+// A wall, open floor or terrain of cost 2-9.
+uint8_t randomCell(std::mt19937& rng) {
+    switch (rng() % 3) {
+    case 0:
+        return CELL_WALL;
+    case 1:
+        return 0;
+    default:
+        return terrainCell(2 + rng() % 8);
+    }
+}
+
+}  // namespace
+
+// Repairs after mixed edits must leave the field a fresh Dijkstra would
+// compute, for tiles small enough that repairs cross many of them, and past
+// the edit count where update() rebuilds instead.
+TEST(flowFieldRepairsMatchDijkstra) {
+    const int rows = 70;
+    const int cols = 90;
+    const MapKind kinds[] = { MapKind::Terrain, MapKind::Rooms };
+    for (int map = 0; map < 2; ++map) {
+        for (unsigned threads : { 1u, 4u }) {
+            for (int tileSize : { 8, 64 }) {
+                GridStorage storage = generateMap(kinds[map], rows, cols, 60 + map);
+                Point goal(rows / 3, cols / 2);
+                storage.set(goal.x, goal.y, 0);
+
+                FlowField field(threads, tileSize);
+                field.build(storage.view(), goal);
+                CHECK(wrongCells(field, storage.view(), goal) == 0);
+
+                std::mt19937 rng(70 + map);
+                size_t wrong = 0;
+                for (int batch = 0; batch < 30; ++batch) {
+                    // mostly repairs; every tenth batch is large enough to rebuild
+                    int edits = batch % 10 == 9 ? rows * cols / 10 : 1 + rng() % 40;
+                    for (int i = 0; i < edits; ++i) {
+                        Point p(rng() % rows, rng() % cols);
+                        if (!(p == goal)) {
+                            storage.set(p.x, p.y, randomCell(rng));
+                            field.cellChanged(p.x, p.y);
+                        }
+                    }
+                    field.update(storage.view());
+                    wrong += wrongCells(field, storage.view(), goal);
+                }
+                CHECK(wrong == 0);
+            }
+        }
+    }
+}
+
+// Grid forwards its edits to the field it hands out and rebuilds it for a
+// new finish.
+TEST(flowFieldThroughGrid) {
+    Grid grid(40, 60, 10, 2);
+    std::mt19937 rng(80);
+    size_t wrong = 0;
+    for (int batch = 0; batch < 25; ++batch) {
+        int edits = batch % 8 == 7 ? 300 : 1 + rng() % 20;
+        for (int i = 0; i < edits; ++i) {
+            Point p(rng() % grid.rows, rng() % grid.cols);
+            if (!grid.isEndpoint(p)) {
+                grid.setCell(p.x, p.y, randomCell(rng));
+            }
+        }
+        if (batch == 12) {
+            grid.finish = Point(grid.rows / 2, grid.cols / 2);
+            grid.setCell(grid.finish.x, grid.finish.y, 0);
+        }
+        const FlowField& field = grid.getFlowField();
+        CHECK(field.getGoal() == grid.finish);
+        wrong += wrongCells(field, grid.view(), grid.finish);
+    }
+    CHECK(wrong == 0);
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Check.h"
+#include "AStar.h"
+#include "Game.h"
+#include "Maps.h"
+
+namespace {
+
+// Terrain cost of the cells after the first, or -1 unless path walks from
+// start to goal over free, 4-adjacent cells.
+template <typename PathVector>
+int walkedCost(const GridView& grid, const PathVector& path, const Point& start, const Point& goal) {
+    if (path.empty() || !(path.front() == start) || !(path.back() == goal)) {
+        return -1;
+    }
+    int cost = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (!grid.contains(path[i]) || grid.isWall(grid.index(path[i]))
+            || std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y) != 1) {
+            return -1;
+        }
+        cost += grid.cost(grid.index(path[i]));
+    }
+    return cost;
+}
+
+// A random cell for which pick holds, found by trying; false if there is none.
+template <typename Predicate>
+bool pickCell(const Grid& grid, std::mt19937& rng, Predicate pick, Point& cell) {
+    for (int tries = 0; tries < 10000; ++tries) {
+        Point p(rng() % grid.rows, rng() % grid.cols);
+        if (!grid.isEndpoint(p) && pick(p)) {
+            cell = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+// The app aims mouse edits through squareAt and skips isEndpoint cells. On a
+// non-square grid, mixing up which coordinate is the row misses the finish.
+TEST(gridMouseEditsSpareTheEndpoints) {
+    const int pitch = 10 + 2;  // square size plus spacing
+    Grid grid(7, 23, 10, 2);
+    CHECK(grid.start == Point(0, 0));
+    CHECK(grid.finish == Point(6, 22));
+
+    // middle of the bottom-right cell: pixel x runs along the columns
+    Point square;
+    CHECK(grid.squareAt(22 * pitch + 5, 6 * pitch + 5, square));
+    CHECK(square == grid.finish && grid.isEndpoint(square));
+    CHECK(grid.squareAt(5, 5, square));
+    CHECK(square == grid.start && grid.isEndpoint(square));
+
+    // the finish's row, far left
+    CHECK(grid.squareAt(5, 6 * pitch + 5, square));
+    CHECK(square == Point(6, 0) && !grid.isEndpoint(square));
+
+    CHECK(!grid.squareAt(10, 5, square));  // spacing
+    CHECK(!grid.squareAt(23 * pitch + 5, 5, square));  // right of the grid
+    CHECK(!grid.squareAt(5, 7 * pitch + 5, square));  // below it
+    CHECK(!grid.squareAt(-1, 5, square));
+
+    CHECK(grid.findPath().size() == 29);
+}
+
+// findPath must return what a fresh Weighted search costs after every edit,
+// and answer from its cache exactly when the edit cannot matter: a wall or a
+// dearer cell off the path. Opening a wall, a cheaper cell and blocking a
+// path cell all search again.
+TEST(gridPathCacheMatchesFreshSearch) {
+    Grid grid(generateMap(MapKind::Terrain, 30, 40, 130).view(), 10, 2);
+    grid.setCell(grid.start.x, grid.start.y, 0);
+    grid.setCell(grid.finish.x, grid.finish.y, 0);
+    AStar path_finder;
+    std::mt19937 rng(131);
+
+    const std::pmr::vector<Point>& first = grid.findPath();
+    std::vector<Point> path(first.begin(), first.end());
+    grid.findPath();  // nothing changed
+    CHECK(grid.getCacheMisses() == 1 && grid.getCacheHits() == 1);
+
+    std::vector<Point> placed;  // walls this test added
+    size_t wrongCost = 0;
+    size_t wrongCounter = 0;
+    for (int step = 0; step < 400; ++step) {
+        auto onPath = [&path](const Point& p) { return std::find(path.begin(), path.end(), p) != path.end(); };
+        auto isWall = [&grid](const Point& p) { return grid.getCell(p.x, p.y) == CELL_WALL; };
+        Point cell;
+        int value = 0;
+        bool hit = false;
+        bool picked = false;
+        switch (step % 5) {
+        case 0:  // wall off the path
+            picked = pickCell(grid, rng, [&](const Point& p) { return !isWall(p) && !onPath(p); }, cell);
+            value = CELL_WALL;
+            hit = true;
+            break;
+        case 1:  // dearer terrain off the path
+            picked = pickCell(grid, rng, [&](const Point& p) {
+                return !isWall(p) && !onPath(p) && grid.getCell(p.x, p.y) != terrainCell(9);
+            }, cell);
+            value = terrainCell(9);
+            hit = true;
+            break;
+        case 2:  // block a path cell
+            picked = pickCell(grid, rng, onPath, cell);
+            value = CELL_WALL;
+            break;
+        case 3:  // open a wall, mostly one placed here so the finish stays reachable
+            if (!placed.empty() && rng() % 3 != 0) {
+                cell = placed.back();
+                placed.pop_back();
+                picked = isWall(cell);
+            }
+            else {
+                picked = pickCell(grid, rng, isWall, cell);
+            }
+            value = rng() % 2 == 0 ? 0 : terrainCell(2 + rng() % 7);
+            break;
+        default:  // cheaper terrain anywhere
+            picked = pickCell(grid, rng, [&](const Point& p) { return grid.getCell(p.x, p.y) >= terrainCell(2); }, cell);
+            value = 0;
+            break;
+        }
+        if (!picked) {
+            continue;
+        }
+
+        if (value == CELL_WALL) {
+            placed.push_back(cell);
+        }
+        unsigned long long hits = grid.getCacheHits();
+        unsigned long long misses = grid.getCacheMisses();
+        grid.setCell(cell.x, cell.y, value);
+        const std::pmr::vector<Point>& found = grid.findPath();
+        path.assign(found.begin(), found.end());
+        wrongCounter += hit ? (grid.getCacheHits() == hits + 1 && grid.getCacheMisses() == misses ? 0 : 1)
+            : (grid.getCacheMisses() == misses + 1 && grid.getCacheHits() == hits ? 0 : 1);
+
+        GridView view = grid.view();
+        int expected = walkedCost(view, path_finder.findPath(view, grid.start, grid.finish, SearchMode::Weighted), grid.start, grid.finish);
+        int cost = walkedCost(view, path, grid.start, grid.finish);
+        wrongCost += cost == expected && (expected >= 0 || path.empty()) ? 0 : 1;
+    }
+    CHECK(wrongCost == 0);
+    CHECK(wrongCounter == 0);
+}
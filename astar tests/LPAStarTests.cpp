@@ -0,0 +1,119 @@
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Check.h"
+#include "AStar.h"
+#include "Game.h"
+#include "LPAStar.h"
+#include "Maps.h"
+
+namespace {
+
+// Terrain cost of the cells after the first, or -1 unless path walks from
+// start to goal over free, 4-adjacent cells.
+template <typename PathVector>
+int walkedCost(const GridView& grid, const PathVector& path, const Point& start, const Point& goal) {
+    if (path.empty() || !(path.front() == start) || !(path.back() == goal)) {
+        return -1;
+    }
+    int cost = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (!grid.contains(path[i]) || grid.isWall(grid.index(path[i]))
+            || std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y) != 1) {
+            return -1;
+        }
+        cost += grid.cost(grid.index(path[i]));
+    }
+    return cost;
+}
+
+// Cost of a fresh Weighted search, -1 if it finds no path.
+int freshCost(const GridView& grid, const Point& start, const Point& goal) {
+    AStar path_finder;
+    return walkedCost(grid, path_finder.findPath(grid, start, goal, SearchMode::Weighted), start, goal);
+}
+
+// A wall, open floor or terrain of cost 2-9.
+uint8_t randomCell(std::mt19937& rng) {
+    switch (rng() % 3) {
+    case 0:
+        return CELL_WALL;
+    case 1:
+        return 0;
+    default:
+        return terrainCell(2 + rng() % 8);
+    }
+}
+
+}  // namespace
+
+// Repairs from the changed cells must cost what a fresh search does, for
+// batches of one cell up to a tenth of the map and while the goal is sealed.
+TEST(lpaRepairsMatchFreshSearch) {
+    const int rows = 50;
+    const int cols = 70;
+    const MapKind kinds[] = { MapKind::Terrain, MapKind::Rooms, MapKind::Random };
+    for (int map = 0; map < 3; ++map) {
+        GridStorage storage = generateMap(kinds[map], rows, cols, 100 + map);
+        Point start(1, 1);
+        Point goal(rows - 2, cols - 2);
+        storage.set(start.x, start.y, 0);
+        storage.set(goal.x, goal.y, 0);
+
+        LPAStar lpa;
+        std::mt19937 rng(110 + map);
+        size_t wrong = 0;
+        for (int batch = 0; batch < 40; ++batch) {
+            std::vector<Point> changed;
+            int edits = batch % 10 == 9 ? rows * cols / 10 : 1 + rng() % 12;
+            for (int i = 0; i < edits; ++i) {
+                Point p(rng() % rows, rng() % cols);
+                if (!(p == start) && !(p == goal)) {
+                    storage.set(p.x, p.y, randomCell(rng));
+                    changed.push_back(p);
+                }
+            }
+            if (batch == 25 || batch == 30) {
+                // seal the goal in, then open it again
+                for (Point p : { Point(goal.x - 1, goal.y), Point(goal.x + 1, goal.y), Point(goal.x, goal.y - 1), Point(goal.x, goal.y + 1) }) {
+                    storage.set(p.x, p.y, batch == 25 ? CELL_WALL : 0);
+                    changed.push_back(p);
+                }
+            }
+            GridView grid = storage.view();
+            const std::pmr::vector<Point>& path = lpa.findPath(grid, start, goal, changed);
+            int expected = freshCost(grid, start, goal);
+            int cost = walkedCost(grid, path, start, goal);
+            wrong += cost == expected && (expected >= 0 || path.empty()) ? 0 : 1;
+        }
+        CHECK(wrong == 0);
+    }
+}
+
+// Grid feeds its change log to LPA* until it holds rows*cols/16 cells and
+// restarts the search past that; both sides of the cap must stay optimal.
+TEST(lpaThroughGridPastTheRepairCap) {
+    Grid grid(generateMap(MapKind::Terrain, 40, 48, 120).view(), 10, 2);
+    grid.setCell(grid.start.x, grid.start.y, 0);
+    grid.setCell(grid.finish.x, grid.finish.y, 0);
+    const int cap = grid.rows * grid.cols / 16;
+
+    std::mt19937 rng(121);
+    size_t wrong = 0;
+    for (int batch = 0; batch < 30; ++batch) {
+        // just below, at and well past the cap every few batches
+        int edits = batch % 5 == 4 ? cap - 1 + batch % 3 * cap / 2 : 1 + rng() % 10;
+        for (int i = 0; i < edits; ++i) {
+            Point p(rng() % grid.rows, rng() % grid.cols);
+            if (!grid.isEndpoint(p)) {
+                grid.setCell(p.x, p.y, randomCell(rng));
+            }
+        }
+        GridView view = grid.view();
+        const std::pmr::vector<Point>& path = grid.findPath();
+        int expected = freshCost(view, grid.start, grid.finish);
+        int cost = walkedCost(view, path, grid.start, grid.finish);
+        wrong += cost == expected && (expected >= 0 || path.empty()) ? 0 : 1;
+    }
+    CHECK(wrong == 0);
+}
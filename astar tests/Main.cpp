@@ -0,0 +1,31 @@
+#include <cstdio>
+#include <cstring>
+#include "Check.h"
+
+// Runs every test, or those whose name contains one of the arguments.
+// Exits with 1 if any check failed.
+int main(int argc, char* argv[])
+{
+    int run = 0;
+    int failed = 0;
+    for (const TestCase& test : testCases()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc && !selected; ++i) {
+            selected = std::strstr(test.name, argv[i]) != nullptr;
+        }
+        if (!selected) {
+            continue;
+        }
+
+        int before = checkFailures();
+        std::printf("%s\n", test.name);
+        test.run();
+        ++run;
+        if (checkFailures() != before) {
+            ++failed;
+        }
+    }
+
+    std::printf("\n%d of %d tests passed\n", run - failed, run);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+#include <climits>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "Check.h"
+#include "OpenList.h"
+
+namespace {
+
+// std::priority_queue with lazy deletion: every change pushes a new entry,
+// and entries whose key is no longer current are skipped when they surface.
+class ReferenceHeap {
+public:
+    explicit ReferenceHeap(size_t capacity) : current(capacity, absent) {}
+
+    bool contains(int id) const { return current[id] != absent; }
+    int key(int id) const { return current[id]; }
+    size_t size() const { return count; }
+
+    void set(int id, int key) {
+        count += contains(id) ? 0 : 1;
+        current[id] = key;
+        queue.push({ key, id });
+    }
+
+    void remove(int id) {
+        current[id] = absent;
+        --count;
+    }
+
+    void clear() {
+        queue = Queue();
+        current.assign(current.size(), absent);
+        count = 0;
+    }
+
+    // Smallest current key; the heap may pop any id that has it.
+    int topKey() {
+        while (queue.top().first != current[queue.top().second]) {
+            queue.pop();
+        }
+        return queue.top().first;
+    }
+
+private:
+    using Entry = std::pair<int, int>;  // key, id
+    using Queue = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+    static constexpr int absent = INT_MIN;  // decreased keys go negative
+
+    Queue queue;
+    std::vector<int> current;
+    size_t count = 0;
+};
+
+// Pops everything, checking the keys come out in order.
+void drainInOrder(IndexedHeap<int>& heap, ReferenceHeap& reference) {
+    while (!heap.empty()) {
+        int key = heap.topKey();
+        CHECK(key == reference.topKey());
+        int id = heap.pop();
+        CHECK(reference.contains(id) && reference.key(id) == key);
+        CHECK(!heap.contains(id));
+        reference.remove(id);
+    }
+    CHECK(reference.size() == 0);
+}
+
+}  // namespace
+
+TEST(heapPopsInKeyOrder) {
+    IndexedHeap<int> heap(8);
+    const int keys[8] = { 5, 3, 7, 1, 4, 6, 2, 0 };
+    for (int id = 0; id < 8; ++id) {
+        heap.push(id, keys[id]);
+    }
+    CHECK(heap.size() == 8);
+    for (int expected = 0; expected < 8; ++expected) {
+        CHECK(heap.topKey() == expected);
+        CHECK(keys[heap.pop()] == expected);
+    }
+    CHECK(heap.empty());
+}
+
+TEST(heapDecreaseKeyMovesToFront) {
+    IndexedHeap<int> heap(4);
+    heap.push(0, 10);
+    heap.push(1, 20);
+    heap.push(2, 30);
+    heap.decreaseKey(2, 5);
+    CHECK(heap.key(2) == 5);
+    CHECK(heap.top() == 2);
+
+    CHECK(!heap.pushOrDecrease(1, 25));  // not better: unchanged
+    CHECK(heap.key(1) == 20);
+    CHECK(heap.pushOrDecrease(1, 1));
+    CHECK(heap.top() == 1);
+    CHECK(heap.pushOrDecrease(3, 0));    // not queued: pushed
+    CHECK(heap.top() == 3);
+    CHECK(heap.size() == 4);
+}
+
+TEST(heapUpdateAndRemove) {
+    IndexedHeap<int> heap(5);
+    for (int id = 0; id < 5; ++id) {
+        heap.push(id, id);
+    }
+    heap.update(0, 9);  // raised: sinks
+    heap.update(4, -1); // lowered: rises
+    heap.remove(2);
+    CHECK(!heap.contains(2));
+    CHECK(heap.size() == 4);
+
+    const int expected[4] = { 4, 1, 3, 0 };
+    for (int id : expected) {
+        CHECK(heap.pop() == id);
+    }
+}
+
+TEST(heapClearKeepsCapacity) {
+    IndexedHeap<int> heap(100);
+    for (int id = 0; id < 100; id += 3) {
+        heap.push(id, 100 - id);
+    }
+    heap.clear();
+    CHECK(heap.empty());
+    CHECK(heap.capacity() == 100);
+    for (int id = 0; id < 100; ++id) {
+        CHECK(!heap.contains(id));
+    }
+
+    heap.resize(100);  // same capacity: only cleared
+    heap.push(7, 1);
+    heap.resize(50);
+    CHECK(heap.empty() && heap.capacity() == 50 && !heap.contains(7));
+}
+
+// Random mixes of every operation, checked against the reference after each.
+TEST(heapMatchesPriorityQueue) {
+    const int capacity = 300;
+    std::mt19937 rng(1);
+    for (int round = 0; round < 200; ++round) {
+        IndexedHeap<int> heap(capacity);
+        ReferenceHeap reference(capacity);
+        for (int step = 0; step < 2000; ++step) {
+            int id = static_cast<int>(rng() % capacity);
+            int key = static_cast<int>(rng() % 1000);
+            switch (rng() % 10) {
+            case 0:
+            case 1:
+            case 2:
+                if (!heap.contains(id)) {
+                    heap.push(id, key);
+                    reference.set(id, key);
+                }
+                break;
+            case 3:
+                if (heap.contains(id)) {
+                    int lower = heap.key(id) - key % 50;
+                    heap.decreaseKey(id, lower);
+                    reference.set(id, lower);
+                }
+                break;
+            case 4:
+                if (heap.pushOrDecrease(id, key)) {
+                    reference.set(id, key);
+                }
+                else {
+                    CHECK(reference.contains(id) && reference.key(id) <= key);
+                }
+                break;
+            case 5:
+                if (heap.contains(id)) {
+                    heap.update(id, key);
+                    reference.set(id, key);
+                }
+                break;
+            case 6:
+                if (heap.contains(id)) {
+                    heap.remove(id);
+                    reference.remove(id);
+                }
+                break;
+            case 7:
+            case 8:
+                if (!heap.empty()) {
+                    int top = heap.topKey();
+                    CHECK(top == reference.topKey());
+                    int popped = heap.pop();
+                    CHECK(reference.contains(popped) && reference.key(popped) == top);
+                    reference.remove(popped);
+                }
+                break;
+            default:
+                if (rng() % 50 == 0) {
+                    heap.clear();
+                    reference.clear();
+                }
+                break;
+            }
+
+            CHECK(heap.size() == reference.size());
+            CHECK(heap.contains(id) == reference.contains(id));
+            if (heap.contains(id)) {
+                CHECK(heap.key(id) == reference.key(id));
+            }
+        }
+        drainInOrder(heap, reference);
+    }
+}
@@ -0,0 +1,92 @@
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Check.h"
+#include "AStar.h"
+#include "Maps.h"
+#include "ParallelAStar.h"
+
+namespace {
+
+struct Query {
+    Point start;
+    Point goal;
+};
+
+// Random cells, walls included, plus the cases a search handles apart:
+// start == goal and a free goal sealed in by walls.
+std::vector<Query> edgeQueries(GridStorage& storage, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<Query> queries;
+    for (int i = 0; i < count; ++i) {
+        Point start(rng() % storage.getRows(), rng() % storage.getCols());
+        Point goal(rng() % storage.getRows(), rng() % storage.getCols());
+        queries.push_back({ start, goal });
+        queries.push_back({ start, start });
+    }
+
+    Point sealed(storage.getRows() / 2, storage.getCols() / 2);
+    storage.set(sealed.x, sealed.y, 0);
+    storage.set(sealed.x - 1, sealed.y, CELL_WALL);
+    storage.set(sealed.x + 1, sealed.y, CELL_WALL);
+    storage.set(sealed.x, sealed.y - 1, CELL_WALL);
+    storage.set(sealed.x, sealed.y + 1, CELL_WALL);
+    for (int i = 0; i < 4; ++i) {
+        queries.push_back({ Point(rng() % storage.getRows(), rng() % storage.getCols()), sealed });
+    }
+    return queries;
+}
+
+// Starts at start, ends at goal, and steps 4-connected over free cells. Like
+// AStar, the search leaves a walled start all the same.
+bool walks(const GridView& grid, const std::vector<Point>& path, const Query& query) {
+    if (path.empty() || !(path.front() == query.start) || !(path.back() == query.goal)) {
+        return false;
+    }
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (!grid.contains(path[i]) || (i > 0 && grid.isWall(grid.index(path[i])))) {
+            return false;
+        }
+        if (i > 0 && std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y) != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+// Path lengths must be those of AStar's Standard mode for every thread count
+// and tile size, tiles of one cell included, where almost every neighbor
+// belongs to another thread.
+TEST(parallelMatchesStandardLengths) {
+    const MapKind kinds[] = { MapKind::Rooms, MapKind::Maze, MapKind::Random };
+    for (int map = 0; map < 3; ++map) {
+        GridStorage storage = generateMap(kinds[map], 60, 80, 40 + map, 0.3);
+        std::vector<Query> queries = edgeQueries(storage, 12, 50 + map);
+        GridView grid = storage.view();
+
+        AStar path_finder;
+        AStar::SearchContext context;
+        std::vector<size_t> expected;
+        for (const Query& query : queries) {
+            expected.push_back(path_finder.findPath(context, grid, query.start, query.goal).size());
+        }
+
+        for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+            for (int tileSize : { 1, 2, 8 }) {
+                ParallelAStar parallel(threads, tileSize);
+                CHECK(parallel.threadCount() == threads);
+                size_t mismatches = 0;
+                size_t broken = 0;
+                for (size_t q = 0; q < queries.size(); ++q) {
+                    const std::vector<Point>& path = parallel.findPath(grid, queries[q].start, queries[q].goal);
+                    mismatches += path.size() == expected[q] ? 0 : 1;
+                    broken += path.empty() || walks(grid, path, queries[q]) ? 0 : 1;
+                }
+                CHECK(mismatches == 0);
+                CHECK(broken == 0);
+            }
+        }
+    }
+}
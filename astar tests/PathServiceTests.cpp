@@ -0,0 +1,188 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Check.h"
+#include "Maps.h"
+#include "PathService.h"
+
+namespace {
+
+struct Edit {
+    unsigned long long version;  // the service's version once the edit was made
+    Point cell;
+    uint8_t value;
+};
+
+// Cheapest cost from start to goal, paid on entering each cell after the
+// start; -1 if the goal cannot be reached.
+int referenceCost(const GridView& grid, const Point& start, const Point& goal) {
+    using Entry = std::pair<int, int>;  // cost, cell
+    std::vector<int> cost(grid.cellCount(), -1);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    cost[grid.index(start)] = 0;
+    open.push({ 0, grid.index(start) });
+    const int offsets[] = { 1, -1, grid.stride, -grid.stride };
+    while (!open.empty()) {
+        Entry top = open.top();
+        open.pop();
+        if (top.first != cost[top.second]) {
+            continue;
+        }
+        for (int offset : offsets) {
+            int next = top.second + offset;
+            int entered = top.first + grid.cost(next);
+            if (!grid.isWall(next) && (cost[next] < 0 || entered < cost[next])) {
+                cost[next] = entered;
+                open.push({ entered, next });
+            }
+        }
+    }
+    return cost[grid.index(goal)];
+}
+
+// Edits cells other than start and goal on its own thread, pause apart, until
+// stop is set or count edits are made; then sets done. Every edit changes the
+// cell, so every call bumps the version. Without walls only terrain changes
+// and the goal stays as reachable as it was. log belongs to the thread until
+// done.
+std::thread streamEdits(PathService& service, GridStorage initial, const Point& start, const Point& goal,
+    unsigned seed, int count, std::chrono::microseconds pause, bool walls,
+    std::atomic<bool>& stop, std::atomic<bool>& done, std::vector<Edit>& log) {
+    return std::thread([&service, initial, start, goal, seed, count, pause, walls, &stop, &done, &log]() mutable {
+        std::mt19937 rng(seed);
+        for (int i = 0; i < count && !stop.load(); ++i) {
+            Point p(rng() % initial.getRows(), rng() % initial.getCols());
+            if (p == start || p == goal || (!walls && initial.get(p.x, p.y) == CELL_WALL)) {
+                continue;
+            }
+            uint8_t value = walls && rng() % 3 == 0 ? CELL_WALL : terrainCell(1 + rng() % 5);
+            if (value == initial.get(p.x, p.y)) {
+                value = value == CELL_WALL || !walls ? 0 : CELL_WALL;
+            }
+            initial.set(p.x, p.y, value);
+            service.setCell(p.x, p.y, value);
+            log.push_back({ service.version(), p, value });
+            if (pause.count() > 0) {
+                std::this_thread::sleep_for(pause);
+            }
+        }
+        done.store(true);
+    });
+}
+
+}  // namespace
+
+// Results published while another thread edits must each be optimal for the
+// grid as of their version, and the reader must never see versions go back.
+TEST(pathServiceResultsMatchTheirVersion) {
+    const int rows = 60;
+    const int cols = 80;
+    GridStorage storage = generateMap(MapKind::Terrain, rows, cols, 90);
+    Point start(0, 0);
+    Point goal(rows - 1, cols - 1);
+    storage.set(start.x, start.y, 0);
+    storage.set(goal.x, goal.y, 0);
+
+    PathService service(storage.view(), 64);
+    service.setEndpoints(start, goal);
+    CHECK(service.waitFor(1, std::chrono::seconds(10)));
+
+    std::atomic<bool> stop{ false };
+    std::atomic<bool> done{ false };
+    std::vector<Edit> log;
+    std::thread editor = streamEdits(service, storage, start, goal, 91, 3000, std::chrono::microseconds(50), true, stop, done, log);
+
+    std::vector<PathResult> seen;
+    unsigned long long lastVersion = 0;
+    bool backwards = false;
+    auto read = [&] {
+        if (service.hasNewResult()) {
+            const PathResult& result = service.latest();
+            backwards = backwards || result.version < lastVersion;
+            lastVersion = result.version;
+            seen.push_back(result);
+        }
+    };
+    while (!done.load()) {
+        read();
+        std::this_thread::yield();
+    }
+    editor.join();
+    CHECK(service.waitFor(service.version(), std::chrono::seconds(10)));
+    read();
+    CHECK(!backwards);
+    CHECK(!seen.empty() && seen.back().version == service.version());
+
+    // replay the edits up to each result's version and search the grid from scratch
+    GridStorage replay = storage;
+    size_t applied = 0;
+    size_t wrong = 0;
+    for (const PathResult& result : seen) {
+        while (applied < log.size() && log[applied].version <= result.version) {
+            replay.set(log[applied].cell.x, log[applied].cell.y, log[applied].value);
+            ++applied;
+        }
+        GridView view = replay.view();
+        int expected = referenceCost(view, start, goal);
+        int walked = 0;
+        for (size_t i = 1; i < result.path.size(); ++i) {
+            walked += view.isWall(view.index(result.path[i])) ? 1 << 20 : view.cost(view.index(result.path[i]));
+        }
+        bool ok = result.start == start && result.goal == goal;
+        if (expected < 0) {
+            ok = ok && result.path.empty();
+        }
+        else {
+            ok = ok && !result.path.empty() && result.cost == expected && walked == expected;
+        }
+        wrong += ok ? 0 : 1;
+    }
+    CHECK(wrong == 0);
+}
+
+// Under edits that never pause, every search but one in maxCancelsInRow + 1
+// may be cancelled; that one must still be published.
+TEST(pathServicePublishesUnderSteadyEdits) {
+    const int rows = 150;
+    const int cols = 200;
+    GridStorage storage = generateMap(MapKind::Rooms, rows, cols, 92);
+    Point start(0, 0);
+    Point goal(rows - 1, cols - 1);
+    storage.set(start.x, start.y, 0);
+    storage.set(goal.x, goal.y, 0);
+
+    // one expansion per slice: any search spans many edits
+    PathService service(storage.view(), 1);
+    std::atomic<bool> stop{ false };
+    std::atomic<bool> done{ false };
+    std::vector<Edit> log;
+    std::thread editor = streamEdits(service, storage, start, goal, 93, 1 << 30, std::chrono::microseconds(0), false,
+        stop, done, log);
+    service.setEndpoints(start, goal);
+    bool publishedMidStream = true;
+    unsigned long long seen = 0;
+    for (int round = 0; round < 5 && publishedMidStream; ++round) {
+        // each round waits for an edit newer than the last result, so needs a new one
+        while (service.version() <= seen) {
+            std::this_thread::yield();
+        }
+        publishedMidStream = service.waitFor(service.version(), std::chrono::seconds(20));
+        seen = service.latest().version;
+    }
+    bool stillEditing = !done.load();
+    stop.store(true);
+    editor.join();
+
+    PathService::Statistics statistics = service.statistics();
+    CHECK(publishedMidStream);
+    CHECK(stillEditing);
+    CHECK(statistics.published >= 5);
+    CHECK(statistics.cancelled >= PathService::maxCancelsInRow);
+    CHECK(statistics.cancelled <= PathService::maxCancelsInRow * statistics.published);
+    CHECK(service.waitFor(service.version(), std::chrono::seconds(10)));
+}
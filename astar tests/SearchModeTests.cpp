@@ -0,0 +1,269 @@
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Check.h"
+#include "AStar.h"
+#include "FringeSearch.h"
+#include "Landmarks.h"
+#include "Maps.h"
+#include "TiledGrid.h"
+
+namespace {
+
+struct Query {
+    Point start;
+    Point goal;
+};
+
+// A map, the same map as a tile file read through a cache of four tiles, its
+// landmark tables, and the queries every variant answers on it.
+struct Fixture {
+    const char* name;
+    GridStorage storage;
+    std::unique_ptr<TiledGrid> tiled;
+    std::string tilePath;
+    Landmarks landmarks = Landmarks(6);
+    std::vector<Query> queries;
+};
+
+// A search under test: its path for a query, and whether it honors terrain
+// costs or counts every passable cell as 1.
+struct Variant {
+    const char* name;
+    bool terrain;
+    std::function<std::vector<Point>(Fixture&, const Query&)> findPath;
+};
+
+// Cheapest cost from start to goal, paid on entering each cell after the
+// start; -1 if the goal cannot be reached.
+int referenceCost(const GridView& grid, const Query& query, bool terrain) {
+    using Entry = std::pair<int, int>;  // cost, cell
+    std::vector<int> cost(grid.cellCount(), -1);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    cost[grid.index(query.start)] = 0;
+    open.push({ 0, grid.index(query.start) });
+    const int offsets[] = { 1, -1, grid.stride, -grid.stride };
+    while (!open.empty()) {
+        Entry top = open.top();
+        open.pop();
+        if (top.first != cost[top.second]) {
+            continue;
+        }
+        for (int offset : offsets) {
+            int next = top.second + offset;
+            int entered = top.first + (terrain ? grid.cost(next) : 1);
+            if (!grid.isWall(next) && (cost[next] < 0 || entered < cost[next])) {
+                cost[next] = entered;
+                open.push({ entered, next });
+            }
+        }
+    }
+    return cost[grid.index(query.goal)];
+}
+
+// Cost of path as the reference counts it, or -1 unless it walks from start
+// to goal over free, 4-adjacent cells.
+int walkedCost(const GridView& grid, const std::vector<Point>& path, const Query& query, bool terrain) {
+    if (path.empty() || !(path.front() == query.start) || !(path.back() == query.goal)) {
+        return -1;
+    }
+    int cost = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (!grid.contains(path[i]) || grid.isWall(grid.index(path[i]))
+            || std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y) != 1) {
+            return -1;
+        }
+        cost += terrain ? grid.cost(grid.index(path[i])) : 1;
+    }
+    return cost;
+}
+
+// Random pairs from free starts; every fifth goal may be a wall and every
+// fifth is the start.
+std::vector<Query> randomQueries(const GridView& grid, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<Query> queries;
+    for (int i = 0; i < count * 20 && static_cast<int>(queries.size()) < count; ++i) {
+        Point start(rng() % grid.rows, rng() % grid.cols);
+        Point goal(rng() % grid.rows, rng() % grid.cols);
+        if (grid.isWall(grid.index(start)) || (grid.isWall(grid.index(goal)) && queries.size() % 5 != 0)) {
+            continue;
+        }
+        queries.push_back({ start, queries.size() % 5 == 1 ? start : goal });
+    }
+    return queries;
+}
+
+// randomQueries plus a free goal sealed in by walls, which storage gets.
+std::vector<Query> queriesFor(GridStorage& storage, int count, unsigned seed) {
+    GridView grid = storage.view();
+    std::vector<Query> queries = randomQueries(grid, count, seed);
+    if (grid.rows >= 3 && grid.cols >= 3) {
+        Point sealed(grid.rows / 2, grid.cols / 2);
+        storage.set(sealed.x, sealed.y, 0);
+        storage.set(sealed.x - 1, sealed.y, CELL_WALL);
+        storage.set(sealed.x + 1, sealed.y, CELL_WALL);
+        storage.set(sealed.x, sealed.y - 1, CELL_WALL);
+        storage.set(sealed.x, sealed.y + 1, CELL_WALL);
+        std::vector<Query> free;
+        for (const Query& query : queries) {
+            if (!grid.isWall(grid.index(query.start))) {
+                free.push_back(query);
+            }
+        }
+        queries.swap(free);
+        for (size_t i = 0; i < 4 && i < queries.size(); ++i) {
+            queries.push_back({ queries[i].start, sealed });
+        }
+    }
+    return queries;
+}
+
+// A single row or column: a wall splits it, so half the queries cannot be answered.
+GridStorage line(int rows, int cols) {
+    GridStorage storage(rows, cols, 0);
+    if (rows == 1) {
+        storage.set(0, cols * 2 / 3, CELL_WALL);
+        storage.set(0, cols / 4, terrainCell(5));
+    }
+    else {
+        storage.set(rows * 2 / 3, 0, CELL_WALL);
+        storage.set(rows / 4, 0, terrainCell(5));
+    }
+    return storage;
+}
+
+std::vector<Fixture> fixtures() {
+    const int rows = 45;
+    const int cols = 61;  // neither a multiple of the tile size
+    std::vector<Fixture> all;
+    all.push_back({ "rooms", generateMap(MapKind::Rooms, rows, cols, 170) });
+    all.push_back({ "maze", generateMap(MapKind::Maze, rows, cols, 171) });
+    all.push_back({ "random", generateMap(MapKind::Random, rows, cols, 172, 0.35) });
+    all.push_back({ "terrain", generateMap(MapKind::Terrain, rows, cols, 173) });
+    all.push_back({ "open", generateMap(MapKind::Open, rows, cols, 174) });
+    all.push_back({ "1xN", line(1, 70) });
+    all.push_back({ "Nx1", line(70, 1) });
+
+    for (size_t i = 0; i < all.size(); ++i) {
+        Fixture& fixture = all[i];
+        fixture.queries = queriesFor(fixture.storage, 40, 180 + static_cast<unsigned>(i));
+        fixture.tilePath = (std::filesystem::temp_directory_path() / ("astar-tests-" + std::to_string(i) + ".tiles")).string();
+        TiledGrid::save(fixture.tilePath, fixture.storage.view(), 8);
+        fixture.tiled = std::make_unique<TiledGrid>(fixture.tilePath, 1);  // the smallest cache: four tiles
+        fixture.landmarks.build(fixture.storage.view());
+    }
+    return all;
+}
+
+std::vector<Point> copied(const std::pmr::vector<Point>& path) {
+    return std::vector<Point>(path.begin(), path.end());
+}
+
+}  // namespace
+
+// Every search mode and backend must find paths as cheap as Dijkstra's, by
+// terrain cost where it honors terrain and by steps where it does not, and
+// none where the goal cannot be reached.
+TEST(searchModesMatchDijkstra) {
+    AStar path_finder;
+    AStar::SearchContext context;
+    FringeSearch fringe;
+    auto mode = [&](SearchMode searchMode) {
+        return [&, searchMode](Fixture& fixture, const Query& query) {
+            return copied(path_finder.findPath(context, fixture.storage.view(), query.start, query.goal, searchMode));
+        };
+    };
+    auto tiled = [&](SearchMode searchMode) {
+        return [&, searchMode](Fixture& fixture, const Query& query) {
+            return copied(path_finder.findPath(context, fixture.tiled->view(), query.start, query.goal, searchMode));
+        };
+    };
+    const Variant variants[] = {
+        { "Standard", false, mode(SearchMode::Standard) },
+        { "JumpPoint", false, mode(SearchMode::JumpPoint) },
+        { "Bidirectional", false, mode(SearchMode::Bidirectional) },
+        { "Weighted", true, mode(SearchMode::Weighted) },
+        { "Landmark", false, [&](Fixture& fixture, const Query& query) {
+            context.setLandmarks(&fixture.landmarks);
+            std::vector<Point> path = copied(path_finder.findPath(context, fixture.storage.view(), query.start, query.goal, SearchMode::Landmark));
+            context.setLandmarks(nullptr);
+            return path;
+        } },
+        { "FringeSearch", false, [&](Fixture& fixture, const Query& query) {
+            return copied(fringe.findPath(fixture.storage.view(), query.start, query.goal));
+        } },
+        { "tiled Standard", false, tiled(SearchMode::Standard) },
+        { "tiled Weighted", true, tiled(SearchMode::Weighted) },
+    };
+
+    std::vector<Fixture> maps = fixtures();
+    for (Fixture& fixture : maps) {
+        GridView grid = fixture.storage.view();
+        CHECK(fixture.tiled->capacity() == 4);
+        for (const Variant& variant : variants) {
+            size_t wrong = 0;
+            for (const Query& query : fixture.queries) {
+                std::vector<Point> path = variant.findPath(fixture, query);
+                int expected = referenceCost(grid, query, variant.terrain);
+                int cost = walkedCost(grid, path, query, variant.terrain);
+                wrong += cost == expected && (expected >= 0 || path.empty()) ? 0 : 1;
+            }
+            if (wrong > 0) {
+                std::printf("  %s on %s: %zu of %zu queries wrong\n", variant.name, fixture.name, wrong, fixture.queries.size());
+            }
+            CHECK(wrong == 0);
+        }
+        CHECK(fixture.tiled->statistics().evictions > 0 || fixture.tiled->tileCount() <= 4);
+        fixture.tiled.reset();  // closes the file
+        std::filesystem::remove(fixture.tilePath);
+    }
+}
+
+// Edits leave the landmark tables stale; after Landmarks::update the
+// Landmark mode must be optimal again, also once a landmark was walled over
+// and update picked new ones.
+TEST(landmarkPathsOptimalAfterUpdate) {
+    const int rows = 50;
+    const int cols = 60;
+    const MapKind kinds[] = { MapKind::Maze, MapKind::Rooms, MapKind::Random };
+    for (int map = 0; map < 3; ++map) {
+        GridStorage storage = generateMap(kinds[map], rows, cols, 190 + map, 0.3);
+        Landmarks landmarks(8);
+        landmarks.build(storage.view());
+        AStar path_finder;
+        AStar::SearchContext context;
+        context.setLandmarks(&landmarks);
+        std::mt19937 rng(195 + map);
+
+        size_t wrong = 0;
+        for (int batch = 0; batch < 12; ++batch) {
+            for (int i = 0; i < 40; ++i) {
+                Point p(rng() % rows, rng() % cols);
+                storage.set(p.x, p.y, storage.get(p.x, p.y) == CELL_WALL || rng() % 3 != 0 ? 0 : CELL_WALL);
+            }
+            if (batch % 4 == 3 && landmarks.count() > 0) {
+                Point landmark = landmarks.points()[batch % landmarks.count()];
+                storage.set(landmark.x, landmark.y, CELL_WALL);
+            }
+            landmarks.update(storage.view());
+            CHECK(landmarks.fits(storage.view()) && landmarks.count() > 0);
+
+            GridView grid = storage.view();
+            for (const Query& query : randomQueries(grid, 30, 200 + batch)) {
+                std::vector<Point> path = copied(path_finder.findPath(context, grid, query.start, query.goal, SearchMode::Landmark));
+                int expected = referenceCost(grid, query, false);
+                int cost = walkedCost(grid, path, query, false);
+                wrong += cost == expected && (expected >= 0 || path.empty()) ? 0 : 1;
+            }
+        }
+        CHECK(wrong == 0);
+    }
+}